@@ -0,0 +1,103 @@
+// Standalone benchmark of the pure C++ helpers in src/*.h. These do not use R, so they can be
+// timed without R and compared across compilers and flags. The kernels that take R objects are
+// benchmarked by run_benchmarks.R.
+//
+// Build and run from this directory:
+//     g++ -O2 -std=c++11 -fopenmp -I../../src header_kernels.cpp -o header_kernels
+//     ./header_kernels [output] [max_events]
+//
+// Writes a csv with the columns
+// kernel, scale_type, scale, repeats, seconds, throughput, rss_peak_mb
+// where seconds is the median of the repeats and rss_peak_mb is the peak resident memory of the
+// process so far (NA where getrusage() is not available).
+
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#ifdef __unix__
+#include <sys/resource.h>
+#endif
+
+#include "CAB_cpp_event_record.h"
+#include "CAB_cpp_rng.h"
+
+static const int repeats = 5;
+
+static double rss_peak_mb(){
+#ifdef __unix__
+    struct rusage usage;
+    getrusage( RUSAGE_SELF, &usage );
+    return( usage.ru_maxrss / 1024.0 );
+#else
+    return( NAN );
+#endif
+}
+
+template <typename F>
+static void benchmark( FILE* output, const char* kernel, double scale, F fx ){
+    std::vector<double> seconds( repeats );
+    for ( int r = 0; r < repeats; r ++ ){
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        fx();
+        seconds[r] = std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+    }
+    std::sort( seconds.begin(), seconds.end() );
+    double median = seconds[ repeats / 2 ];
+    fprintf( output, "%s,events,%.0f,%d,%.9g,%.9g,%.6g\n", kernel, scale, repeats, median, scale / std::max( median, 1e-12 ), rss_peak_mb() );
+    fprintf( stderr, "%-28s %12.0f %12.6fs\n", kernel, scale, median );
+}
+
+int main( int argc, char** argv ){
+
+    const char* output_name = argc > 1 ? argv[1] : "CAB_header_benchmarks.csv";
+    double max_events = argc > 2 ? atof( argv[2] ) : 1e7;
+
+    FILE* output = fopen( output_name, "w" );
+    if ( !output ){
+        fprintf( stderr, "Cannot open %s\n", output_name );
+        return( 1 );
+    }
+    fprintf( output, "kernel,scale_type,scale,repeats,seconds,throughput,rss_peak_mb\n" );
+
+    xoshiro256 rng( 1 );
+    const int n_labels = 5;
+
+    for ( double scale = 1e3; scale <= max_events; scale *= 10 ){
+        int n = (int) scale;
+
+        std::vector<int> codes( n );
+        std::vector<double> times( n );
+        double time = 0;
+        for ( int i = 0; i < n; i ++ ){
+            codes[i] = rng.bounded( n_labels );
+            time += rng.exponential();
+            times[i] = time;
+        }
+
+        label_index index;
+        benchmark( output, "build_label_index", scale, [&](){ build_label_index( &codes[0], n, n_labels, index ); } );
+
+        std::vector<int> label_rows;
+        int gather_codes[2] = { 0, 1 };
+        benchmark( output, "gather_label_rows", scale, [&](){ gather_label_rows( &index.offsets[0], &index.rows[0], gather_codes, 2, label_rows ); } );
+
+        int n_windows = count_windows( 0, time, 60, 10 );
+        std::vector<int> counts( n_windows );
+        benchmark( output, "window_counts", scale, [&](){ window_counts( &times[0], n, 0, 60, 10, n_windows, &counts[0] ); } );
+
+        std::vector<double> draws( n );
+        benchmark( output, "xoshiro256_uniform", scale, [&](){ for ( int i = 0; i < n; i ++ ) draws[i] = rng.uniform(); } );
+        benchmark( output, "xoshiro256_normal", scale, [&](){ for ( int i = 0; i < n; i ++ ) draws[i] = rng.normal(); } );
+
+        std::vector<int> permutation;
+        std::vector<int> sample( n );
+        benchmark( output, "partial_fisher_yates", scale, [&](){ partial_fisher_yates( rng, permutation, n, n, &sample[0] ); } );
+    }
+
+    fclose( output );
+    return( 0 );
+}
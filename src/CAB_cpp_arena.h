@@ -0,0 +1,172 @@
+#ifndef CAB_CPP_ARENA_H
+#define CAB_CPP_ARENA_H
+
+#include <vector>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include "CAB_cpp_profile.h"
+
+// Per-thread scratch memory for the compiled kernels.
+// A scratch_arena hands out memory by bumping an offset through a list of blocks, and a scratch_scope gives
+// back everything allocated since it was opened when it closes, so temporaries cost no call to malloc once
+// the blocks of a thread have grown to fit its kernels. The blocks are kept for the life of the thread, up to
+// RETAINED bytes: when every scope of a thread has closed, the largest blocks beyond that are freed, so one
+// large call does not pin its memory to the thread.
+// Every thread has its own arena from thread_arena(), so kernels running in threads do not contend for the
+// heap. Only plain data (ints, doubles) goes in an arena: nothing is constructed or destroyed.
+
+class scratch_arena {
+public:
+    struct mark_type {
+        size_t block;
+        size_t offset;
+    };
+
+    scratch_arena() : block( 0 ), offset( 0 ) {}
+
+    ~scratch_arena(){
+        for ( size_t i = 0; i < blocks.size(); i ++ ) std::free( blocks[i].data );
+    }
+
+    // The one place where kernel allocations are counted for model_profile()
+    template <typename T>
+    T* allocate( size_t n ){
+        CAB_PROFILE_ALLOCATION();
+        return( (T*) allocate_bytes( n * sizeof(T) ) );
+    }
+
+    mark_type mark() const {
+        mark_type m = { block, offset };
+        return( m );
+    }
+
+    void rewind( const mark_type& m ){
+        block = m.block;
+        offset = m.offset;
+        if ( block == 0 && offset == 0 ) trim();
+    }
+
+    static const size_t RETAINED = (size_t) 1 << 25;
+
+private:
+    struct memory_block {
+        char* data;
+        size_t size;
+    };
+
+    static const size_t ALIGNMENT = 16;
+    static const size_t FIRST_BLOCK = 1 << 16;
+
+    std::vector<memory_block> blocks;
+    size_t block;   // the block being bumped through
+    size_t offset;  // the next free byte in it
+
+    scratch_arena( const scratch_arena& );
+    scratch_arena& operator=( const scratch_arena& );
+
+    // Frees the last, largest, blocks while more than RETAINED bytes are held. Only called when the arena is empty.
+    void trim(){
+        size_t held = 0;
+        for ( size_t i = 0; i < blocks.size(); i ++ ) held += blocks[i].size;
+        while ( held > RETAINED && !blocks.empty() ){
+            held -= blocks.back().size;
+            std::free( blocks.back().data );
+            blocks.pop_back();
+        }
+    }
+
+    void* allocate_bytes( size_t bytes ){
+        bytes = ( bytes + ALIGNMENT - 1 ) & ~( ALIGNMENT - 1 );
+        if ( bytes == 0 ) bytes = ALIGNMENT;
+        while ( block < blocks.size() && blocks[block].size - offset < bytes ){
+            block ++;
+            offset = 0;
+        }
+        if ( block == blocks.size() ){
+            // Blocks double, so a thread makes O( log ) of them
+            size_t size = blocks.empty() ? FIRST_BLOCK : 2 * blocks.back().size;
+            while ( size < bytes ) size *= 2;
+            memory_block b = { (char*) std::malloc( size ), size };
+            if ( b.data == NULL ) throw std::bad_alloc();
+            blocks.push_back( b );
+        }
+        void* at = blocks[block].data + offset;
+        offset += bytes;
+        return( at );
+    }
+};
+
+inline scratch_arena& thread_arena(){
+    static thread_local scratch_arena arena;
+    return( arena );
+}
+
+// Rewinds the arena of the thread to where it was when the scope opened
+class scratch_scope {
+public:
+    scratch_scope() : arena( thread_arena() ), start( arena.mark() ) {}
+    ~scratch_scope(){
+        arena.rewind( start );
+    }
+    scratch_arena& arena;
+
+private:
+    scratch_arena::mark_type start;
+
+    scratch_scope( const scratch_scope& );
+    scratch_scope& operator=( const scratch_scope& );
+};
+
+// A growable array of plain data in the arena of the thread. Give reserve() an upper bound on the size
+// where one is cheap, so the array is allocated once. Growing leaves the old storage in the arena until the
+// enclosing scratch_scope closes.
+template <typename T>
+class scratch_vector {
+public:
+    scratch_vector() : arena( thread_arena() ), items( NULL ), n( 0 ), capacity( 0 ) {}
+
+    explicit scratch_vector( size_t n, T value = T() ) : arena( thread_arena() ), items( NULL ), n( 0 ), capacity( 0 ) {
+        assign( n, value );
+    }
+
+    void reserve( size_t size ){
+        if ( size <= capacity ) return;
+        T* grown = arena.allocate<T>( size );
+        if ( n > 0 ) std::memcpy( grown, items, n * sizeof(T) );
+        items = grown;
+        capacity = size;
+    }
+
+    void assign( size_t size, T value ){
+        reserve( size );
+        for ( size_t i = 0; i < size; i ++ ) items[i] = value;
+        n = size;
+    }
+
+    void push_back( T x ){
+        if ( n == capacity ) reserve( capacity < 8 ? 16 : 2 * capacity );
+        items[ n ++ ] = x;
+    }
+
+    void clear(){
+        n = 0;
+    }
+
+    size_t size() const { return( n ); }
+    bool empty() const { return( n == 0 ); }
+    T* begin() { return( items ); }
+    T* end() { return( items + n ); }
+    const T* begin() const { return( items ); }
+    const T* end() const { return( items + n ); }
+    T& operator[]( size_t i ) { return( items[i] ); }
+    const T& operator[]( size_t i ) const { return( items[i] ); }
+
+private:
+    scratch_arena& arena;
+    T* items;
+    size_t n;
+    size_t capacity;
+};
+
+#endif
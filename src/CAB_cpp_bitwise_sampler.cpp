@@ -1,6 +1,7 @@
 // [[Rcpp::depends(RcppArmadillo)]]
 
 #include <RcppArmadillo.h>
+#include "CAB_cpp_profile.h"
 using namespace Rcpp ;
 
 //'@export EBD_BR
@@ -8,6 +9,8 @@ using namespace Rcpp ;
 // [[Rcpp::export]]
 arma::umat EBD_BR( arma::umat fathers, arma::umat mothers ){
 
+    CAB_PROFILE_SCOPE( PROFILE_RECOMBINATION );
+
     arma::umat p = arma::randi<arma::umat>( fathers.n_rows, fathers.n_cols, arma::distr_param(0,1) );
     arma::umat return_matrix = p % fathers + (1-p) % mothers;
 
@@ -19,6 +22,8 @@ arma::umat EBD_BR( arma::umat fathers, arma::umat mothers ){
 // [[Rcpp::export]]
 arma::umat EBD_RS_BR( arma::umat parents ){
 
+    CAB_PROFILE_SCOPE( PROFILE_RECOMBINATION );
+
     IntegerVector choose = wrap( seq_len( parents.n_cols ) -1 );
 
     arma::umat fathers( parents.n_rows, parents.n_cols );
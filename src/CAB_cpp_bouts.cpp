@@ -0,0 +1,175 @@
+#include <Rcpp.h>
+#include <algorithm>
+#include "CAB_cpp_arena.h"
+#include "CAB_cpp_event_record.h"
+using namespace Rcpp;
+
+// Bouts of responses and visits to alternatives, found in one pass over a formal event record.
+// A bout is a run of events with the same label, each within gap of the one before, with no break event
+// in between. With one label these are the bouts of a response. With several labels a bout ends when
+// another label occurs, so the bouts are the visits to each alternative and a bout that follows a bout of
+// another label with no break in between starts with a changeover.
+// The walk is the state machine of CAB_cpp_clean_short_ixxi, with the breaks of compute_ixyi_FER_breaks.
+
+struct bout_walk {
+    int n_labels;
+    double gap;
+
+    // Bouts so far
+    scratch_vector<int> label;
+    scratch_vector<double> start, end;
+    scratch_vector<int> count;
+    scratch_vector<int> changeover;
+
+    // Totals for each label
+    std::vector<int> bouts, responses;
+    std::vector<double> time_in_bouts;
+
+    // The open bout is the last one
+    bool in_bout;
+    int previous;   // label of the last bout in the chain, or -1 after a break
+
+    bout_walk( int n_labels, double gap, int n_rows ) :
+        n_labels( n_labels ), gap( gap ),
+        bouts( n_labels, 0 ), responses( n_labels, 0 ), time_in_bouts( n_labels, 0 ),
+        in_bout( false ), previous( -1 ) {
+        // Every bout needs a row of its own
+        label.reserve( n_rows );
+        start.reserve( n_rows );
+        end.reserve( n_rows );
+        count.reserve( n_rows );
+        changeover.reserve( n_rows );
+    }
+
+    void close(){
+        if ( !in_bout ) return;
+        int b = label.size() - 1;
+        bouts[ label[b] ] ++;
+        responses[ label[b] ] += count[b];
+        time_in_bouts[ label[b] ] += end[b] - start[b];
+        in_bout = false;
+    }
+
+    // codes[i] is the label of row i from 0, -2 for a break event and -1 for anything else. Events with
+    // missing times are skipped, but breaks still end the chain whatever their time.
+    void walk( const double* times, const int* codes, int n_rows ){
+        for ( int i = 0; i < n_rows; i ++ ){
+            int code = codes[i];
+            if ( code == -1 ) continue;
+
+            if ( code == -2 ){
+                close();
+                previous = -1;
+                continue;
+            }
+            if ( missing_time( times[i] ) ) continue;
+
+            int b = label.size() - 1;
+            if ( in_bout && code == previous && times[i] - end[b] <= gap ){
+                end[b] = times[i];
+                count[b] ++;
+                continue;
+            }
+
+            close();
+            label.push_back( code );
+            start.push_back( times[i] );
+            end.push_back( times[i] );
+            count.push_back( 1 );
+            changeover.push_back( previous >= 0 && previous != code );
+            previous = code;
+            in_bout = true;
+        }
+        close();
+    }
+};
+
+// [[Rcpp::export]]
+List CAB_cpp_bouts( DataFrame data, CharacterVector labels, CharacterVector break_events, double gap, double session_duration, NumericVector length_breaks ){
+
+    if ( !( gap >= 0 ) ) stop( "'gap' must not be negative" );
+    for ( int b = 1; b < length_breaks.length(); b ++ ){
+        if ( !( length_breaks[b] > length_breaks[b-1] ) ) stop( "'length_breaks' must be increasing" );
+    }
+
+    NumericVector times = data["time"];
+    CharacterVector events = data["event"];
+    int n_rows = times.length();
+    int n_labels = labels.length();
+
+    // match() indexes from 1, subtract 1
+    IntegerVector matched = match( events, labels );
+    IntegerVector breaking = match( events, break_events );
+    std::vector<int> codes( n_rows );
+    for ( int i = 0; i < n_rows; i ++ ){
+        if ( matched[i] != NA_INTEGER ) codes[i] = matched[i] - 1;
+        else if ( breaking[i] != NA_INTEGER ) codes[i] = -2;
+        else codes[i] = -1;
+    }
+
+    scratch_scope scope;
+    bout_walk bouts( n_labels, gap, n_rows );
+    bouts.walk( times.begin(), codes.data(), n_rows );
+    int n_bouts = bouts.label.size();
+
+    // Histograms of the bouts of each label by the number of responses and by length
+    int max_count = 0;
+    for ( int b = 0; b < n_bouts; b ++ ) max_count = std::max( max_count, bouts.count[b] );
+    int n_bins = std::max( 0, (int) length_breaks.length() - 1 );
+    IntegerMatrix count_histogram( max_count, n_labels );
+    IntegerMatrix length_histogram( n_bins, n_labels );
+
+    IntegerVector bout_label( n_bouts );
+    NumericVector bout_start( n_bouts ), bout_end( n_bouts ), bout_length( n_bouts );
+    IntegerVector bout_count( n_bouts );
+    LogicalVector bout_changeover( n_bouts );
+    for ( int b = 0; b < n_bouts; b ++ ){
+        bout_label[b] = bouts.label[b];
+        bout_start[b] = bouts.start[b];
+        bout_end[b] = bouts.end[b];
+        bout_length[b] = bouts.end[b] - bouts.start[b];
+        bout_count[b] = bouts.count[b];
+        bout_changeover[b] = bouts.changeover[b];
+
+        count_histogram( bouts.count[b] - 1, bouts.label[b] ) ++;
+        // Bins are [ length_breaks[k], length_breaks[k+1] ), and the last bin also takes its upper break
+        int bin = std::upper_bound( length_breaks.begin(), length_breaks.end(), bout_length[b] ) - length_breaks.begin() - 1;
+        if ( bin == n_bins && n_bins > 0 && bout_length[b] == length_breaks[ n_bins ] ) bin = n_bins - 1;
+        if ( bin >= 0 && bin < n_bins ) length_histogram( bin, bouts.label[b] ) ++;
+    }
+    colnames( count_histogram ) = labels;
+    colnames( length_histogram ) = labels;
+
+    // The first response of a bout initiates it and the rest are within the bout
+    NumericVector initiation_rate( n_labels ), within_bout_rate( n_labels );
+    IntegerVector label_bouts( bouts.bouts.begin(), bouts.bouts.end() );
+    IntegerVector label_responses( bouts.responses.begin(), bouts.responses.end() );
+    NumericVector label_time( bouts.time_in_bouts.begin(), bouts.time_in_bouts.end() );
+    for ( int l = 0; l < n_labels; l ++ ){
+        initiation_rate[l] = label_bouts[l] / ( session_duration - label_time[l] );
+        within_bout_rate[l] = ( label_responses[l] - label_bouts[l] ) / label_time[l];
+    }
+
+    DataFrame summary = DataFrame::create(
+        Named("event") = labels,
+        Named("bouts") = label_bouts,
+        Named("responses") = label_responses,
+        Named("time_in_bouts") = label_time,
+        Named("initiation_rate") = initiation_rate,
+        Named("within_bout_rate") = within_bout_rate,
+        Named("stringsAsFactors") = false );
+
+    List bout_columns = List::create(
+        Named("event") = bout_label,
+        Named("start") = bout_start,
+        Named("end") = bout_end,
+        Named("length") = bout_length,
+        Named("count") = bout_count,
+        Named("changeover") = bout_changeover );
+
+    return( List::create(
+        Named("bouts") = bout_columns,
+        Named("summary") = summary,
+        Named("count_histogram") = count_histogram,
+        Named("length_histogram") = length_histogram ) );
+}
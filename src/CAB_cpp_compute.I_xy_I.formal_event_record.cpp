@@ -1,4 +1,5 @@
 #include <Rcpp.h>
+#include "CAB_cpp_arena.h"
 using namespace Rcpp;
 
 // Stuff
@@ -8,7 +9,10 @@ NumericVector CAB_cpp_compute__I_xy_I__formal_event_record( DataFrame data, Char
 
     NumericVector times = data["time"];
     CharacterVector events = data["event"];
-    std::vector<double> differences(0);
+    // Every interval needs an x row and a y row of its own
+    scratch_scope scope;
+    scratch_vector<double> differences;
+    differences.reserve( times.length() / 2 + 1 );
     double x_val = R_PosInf;
     IntegerVector breaking = match( events, break_event );
 
@@ -24,5 +28,5 @@ NumericVector CAB_cpp_compute__I_xy_I__formal_event_record( DataFrame data, Char
             x_val = R_PosInf;
         }
     }
-    return wrap( differences );
+    return( NumericVector( differences.begin(), differences.end() ) );
 }
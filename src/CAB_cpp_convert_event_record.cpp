@@ -0,0 +1,80 @@
+#include <Rcpp.h>
+#include "CAB_cpp_event_record.h"
+using namespace Rcpp;
+
+// formal_event_record -> ragged_event_record
+// One counting pass and one scatter pass into preallocated vectors, one for each variable.
+
+// [[Rcpp::export]]
+List CAB_cpp_formal_to_ragged( DataFrame data, CharacterVector variables ){
+
+    NumericVector times = data["time"];
+    CharacterVector events = data["event"];
+    IntegerVector matched = match( events, variables );
+
+    int n_rows = times.length();
+    int n_variables = variables.length();
+
+    std::vector<int> codes( n_rows );
+    for ( int i = 0; i < n_rows; i ++ ){
+        // match() indexes from 1, subtract 1
+        codes[i] = matched[i] == NA_INTEGER ? -1 : matched[i] - 1;
+    }
+
+    label_index index;
+    build_label_index( codes.data(), n_rows, n_variables, index );
+
+    List ragged( n_variables );
+    for ( int v = 0; v < n_variables; v ++ ){
+        int first = index.offsets[v];
+        NumericVector variable_times( index.offsets[v+1] - first );
+        for ( int i = 0; i < variable_times.length(); i ++ ){
+            variable_times[i] = times[ index.rows[ first + i ] ];
+        }
+        ragged[v] = variable_times;
+    }
+    ragged.names() = variables;
+
+    return( ragged );
+}
+
+// ragged_event_record -> formal_event_record
+// A k-way merge of the variables by time into preallocated columns. Only the first counts[v] times
+// of each variable are used. Ties are broken by the order of the variables, so that a response is
+// placed before the reinforcement that it produced when variables = c( "resp_time", "rft_time" ).
+
+// [[Rcpp::export]]
+List CAB_cpp_ragged_to_formal( List event_times, IntegerVector counts, CharacterVector variables ){
+
+    int n_variables = variables.length();
+    std::vector<const double*> heads( n_variables );
+    std::vector<int> remaining( n_variables );
+    int n_rows = 0;
+
+    for ( int v = 0; v < n_variables; v ++ ){
+        NumericVector times = event_times[v];
+        heads[v] = times.begin();
+        remaining[v] = std::min( (int) times.length(), counts[v] );
+        n_rows += remaining[v];
+    }
+
+    NumericVector time( n_rows );
+    CharacterVector event( n_rows );
+
+    for ( int i = 0; i < n_rows; i ++ ){
+        // k is the number of variables in a record, which is small, so a linear scan beats a heap
+        int next = -1;
+        for ( int v = 0; v < n_variables; v ++ ){
+            if ( remaining[v] > 0 && ( next < 0 || *heads[v] < *heads[next] ) ){
+                next = v;
+            }
+        }
+        time[i] = *heads[next];
+        event[i] = variables[next];
+        heads[next] ++;
+        remaining[next] --;
+    }
+
+    List return_list = List::create( Named("time") = time, Named("event") = event );
+    return( return_list );
+}
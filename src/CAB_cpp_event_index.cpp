@@ -0,0 +1,25 @@
+#include <Rcpp.h>
+#include "CAB_cpp_event_record.h"
+using namespace Rcpp;
+
+// Label index of a formal_event_record.
+// The rows are counted from 0 and the rows for labels[l] are rows[ offsets[l] ] to rows[ offsets[l+1] - 1 ].
+
+// [[Rcpp::export]]
+List CAB_cpp_event_label_index( CharacterVector event, CharacterVector labels ){
+
+    IntegerVector matched = match( event, labels );
+    int n_rows = event.length();
+
+    std::vector<int> codes( n_rows );
+    for ( int i = 0; i < n_rows; i ++ ){
+        // match() indexes from 1, subtract 1
+        codes[i] = matched[i] == NA_INTEGER ? -1 : matched[i] - 1;
+    }
+
+    label_index index;
+    build_label_index( codes.data(), n_rows, labels.length(), index );
+
+    List return_list = List::create( Named("offsets") = index.offsets, Named("rows") = index.rows );
+    return( return_list );
+}
@@ -0,0 +1,144 @@
+#ifndef CAB_CPP_EVENT_RECORD_H
+#define CAB_CPP_EVENT_RECORD_H
+
+#include <vector>
+#include <algorithm>
+#include <climits>
+
+// Helpers shared by the kernels that work on event records.
+// Nothing in here touches R objects, so they can be called from inside threads.
+
+// Rows of an event record bucketed by label.
+// The rows for label l are rows[ offsets[l] ] to rows[ offsets[l+1] - 1 ], in record order.
+struct label_index {
+    std::vector<int> offsets;
+    std::vector<int> rows;
+};
+
+// codes[i] is the label of row i, counting from 0. Rows with codes < 0 are skipped.
+inline void build_label_index( const int* codes, int n_rows, int n_labels, label_index& index ){
+
+    index.offsets.assign( n_labels + 1, 0 );
+
+    // Counting pass
+    for ( int i = 0; i < n_rows; i ++ ){
+        if ( codes[i] >= 0 ){
+            index.offsets[ codes[i] + 1 ] ++;
+        }
+    }
+    for ( int l = 0; l < n_labels; l ++ ){
+        index.offsets[l+1] += index.offsets[l];
+    }
+
+    // Scatter pass
+    index.rows.resize( index.offsets[ n_labels ] );
+    std::vector<int> cursor( index.offsets.begin(), index.offsets.end() - 1 );
+    for ( int i = 0; i < n_rows; i ++ ){
+        if ( codes[i] >= 0 ){
+            index.rows[ cursor[ codes[i] ] ++ ] = i;
+        }
+    }
+}
+
+// Rows of all the given label codes from a label index, merged into record order.
+// Codes < 0 are labels that do not occur in the record and contribute no rows.
+inline void gather_label_rows( const int* offsets, const int* rows, const int* codes, int n_codes, std::vector<int>& label_rows ){
+
+    label_rows.clear();
+    for ( int c = 0; c < n_codes; c ++ ){
+        if ( codes[c] >= 0 ){
+            label_rows.insert( label_rows.end(), rows + offsets[ codes[c] ], rows + offsets[ codes[c] + 1 ] );
+        }
+    }
+
+    if ( n_codes > 1 ){
+        std::sort( label_rows.begin(), label_rows.end() );
+        label_rows.erase( std::unique( label_rows.begin(), label_rows.end() ), label_rows.end() );
+    }
+}
+
+// Missing times: NA integer ticks, which R stores as INT_MIN, and NaN doubles
+inline bool missing_time( int time ){
+    return( time == INT_MIN );
+}
+
+inline bool missing_time( double time ){
+    return( time != time );
+}
+
+// Number of windows [ start + w * step, start + w * step + window ) that fit inside [ start, end ].
+inline int count_windows( double start, double end, double window, double step ){
+    // Written so that NaN ends give no windows
+    if ( !( end - start >= window ) ) return( 0 );
+    return( (int) ( ( end - start - window ) / step + 1e-9 ) + 1 );
+}
+
+// Counts of sorted times in each window with two pointers. O( n_times + n_windows ).
+// The times can be doubles or integer ticks, with the windows in the same units. Missing times are passed
+// over and not counted, wherever they are.
+template< typename Time >
+inline void window_counts( const Time* times, int n_times, double start, double window, double step, int n_windows, int* counts ){
+
+    int lower = 0;
+    int upper = 0;
+    // Missing times before lower and before upper
+    int missing_lower = 0;
+    int missing_upper = 0;
+
+    for ( int w = 0; w < n_windows; w ++ ){
+        double window_start = start + w * step;
+        double window_end = window_start + window;
+
+        while ( lower < n_times && ( missing_time( times[lower] ) || times[lower] < window_start ) ){
+            missing_lower += missing_time( times[lower] );
+            lower ++;
+        }
+        if ( upper < lower ){
+            upper = lower;
+            missing_upper = missing_lower;
+        }
+        while ( upper < n_times && ( missing_time( times[upper] ) || times[upper] < window_end ) ){
+            missing_upper += missing_time( times[upper] );
+            upper ++;
+        }
+
+        counts[w] = upper - lower - ( missing_upper - missing_lower );
+    }
+}
+
+// Counts of the transitions between labels at lags 1 to max_lag, in one pass over the record.
+// codes[i] is the label of row i, from 0. Labels from n_labels up are not counted but can be breaks, and
+// rows with codes < 0 are skipped. breaks[c] is nonzero if label c is a break event: a break ends the chain,
+// so no transition is counted across it, and a counted break starts the next chain itself.
+// counts is a n_labels x n_labels x max_lag column-major array, with the transition from a to b at lag k in
+// counts[ a + n_labels * ( b + n_labels * ( k - 1 ) ) ]. It is added to, not cleared.
+inline void transition_counts( const int* codes, int n_rows, const int* breaks, int n_labels, int max_lag, int* counts ){
+
+    // The last max_lag counted labels of the chain, as a ring buffer with the latest at history[ head ]
+    std::vector<int> history( max_lag );
+    int head = 0;
+    int n_history = 0;
+    int square = n_labels * n_labels;
+
+    for ( int i = 0; i < n_rows; i ++ ){
+        int to = codes[i];
+        if ( to < 0 ) continue;
+
+        if ( to < n_labels ){
+            int position = head;
+            for ( int k = 0; k < n_history; k ++ ){
+                counts[ history[ position ] + n_labels * to + square * k ] ++;
+                position = position == 0 ? max_lag - 1 : position - 1;
+            }
+        }
+
+        if ( breaks[ to ] ) n_history = 0;
+        if ( to < n_labels ){
+            head = head == max_lag - 1 ? 0 : head + 1;
+            history[ head ] = to;
+            if ( n_history < max_lag ) n_history ++;
+        }
+    }
+}
+
+#endif
@@ -1,6 +1,15 @@
 #include <Rcpp.h>
+#include "CAB_cpp_profile.h"
 using namespace Rcpp;
 
+// Index of the first organism with the fitness, from 1 as in match(), or NA_INTEGER
+static int first_match( double value, const double* fitness, int n ){
+    for ( int i = 0; i < n; i ++ ){
+        if ( fitness[i] == value ) return( i + 1 );
+    }
+    return( NA_INTEGER );
+}
+
 // This is a simple example of exporting a C++ function to R. You can
 // source this function into an R session using the Rcpp::sourceCpp
 // function (or via the Source button on the editor toolbar). Learn
@@ -14,27 +23,30 @@ using namespace Rcpp;
 // [[Rcpp::export]]
 List CAB_cpp_geometric_fitness_selection( NumericVector fitness, int pop_size, double p ){
 
+    CAB_PROFILE_SCOPE( PROFILE_SELECTION );
+
     IntegerVector father_index = rep( NA_INTEGER , pop_size );
     IntegerVector mother_index = rep( NA_INTEGER, pop_size );
     bool got_father = false;
     bool got_mother = false;
 
+    // Draws are matched against the fitness in place, so the loop allocates nothing
+    const double* fitness_values = fitness.begin();
+    int n = fitness.length();
     for ( int parent = 0; parent < pop_size; parent ++ ){
-        IntegerVector matching(1);
+        int matching = NA_INTEGER;
         while ( ! got_father ){
-            NumericVector father_fitness = rgeom( 1, p );
-            matching = match( father_fitness, fitness )[0];
-            if ( !is_na(matching)[0] ){
-                father_index[parent] = matching[0];
+            matching = first_match( R::rgeom( p ), fitness_values, n );
+            if ( matching != NA_INTEGER ){
+                father_index[parent] = matching;
                 got_father = !got_father;
             }
 
         }
         while ( ! got_mother ){
-            NumericVector mother_fitness = rgeom( 1, p );
-            matching = match( mother_fitness, fitness );
-            if ( ( !is_na(matching)[0] ) & ( matching[0] != father_index[parent] ) ){
-                mother_index[parent] = matching[0];
+            matching = first_match( R::rgeom( p ), fitness_values, n );
+            if ( ( matching != NA_INTEGER ) & ( matching != father_index[parent] ) ){
+                mother_index[parent] = matching;
                 got_mother = !got_mother;
             }
         }
@@ -0,0 +1,130 @@
+#include <Rcpp.h>
+#include <cstring>
+#include <cstdio>
+#include "CAB_cpp_radix.h"
+using namespace Rcpp;
+
+// A 128 bit hash of an R object that is the same in every session and on every run.
+// The object is walked by type: its length, data and attributes are hashed, with doubles through their
+// radix keys so that -0 hashes as 0 and every NaN other than NA hashes the same. Strings are hashed as
+// UTF-8. Environments and closures cannot be hashed; simulation_key() turns them into lists and text first.
+// External pointers are only meaningful inside one session, so they are hashed by their type alone.
+
+struct stable_hash {
+    uint64_t h1, h2;
+
+    stable_hash() : h1( 0x9E3779B97F4A7C15ULL ), h2( 0xD1B54A32D192ED03ULL ) {}
+
+    // The splitmix64 finaliser
+    static uint64_t mix( uint64_t z ){
+        z = ( z ^ ( z >> 30 ) ) * 0xBF58476D1CE4E5B9ULL;
+        z = ( z ^ ( z >> 27 ) ) * 0x94D049BB133111EBULL;
+        return( z ^ ( z >> 31 ) );
+    }
+
+    void word( uint64_t x ){
+        h1 = mix( h1 ^ x );
+        h2 = mix( h2 + x + 0x632BE59BD9B4E019ULL );
+    }
+
+    void bytes( const char* data, size_t n ){
+        word( n );
+        size_t i = 0;
+        for ( ; i + 8 <= n; i += 8 ){
+            uint64_t x;
+            std::memcpy( &x, data + i, 8 );
+            word( x );
+        }
+        if ( i < n ){
+            uint64_t x = 0;
+            std::memcpy( &x, data + i, n - i );
+            word( x );
+        }
+    }
+
+    void string( SEXP s ){
+        if ( s == NA_STRING ){
+            word( 0xFFFFFFFFFFFFFFFFULL );
+            return;
+        }
+        const char* text = Rf_translateCharUTF8( s );
+        bytes( text, std::strlen( text ) );
+    }
+
+    void object( SEXP x ){
+        int type = TYPEOF( x );
+        word( type );
+
+        switch ( type ){
+            case NILSXP:
+            case EXTPTRSXP:
+                return;
+            case SYMSXP:
+                string( PRINTNAME( x ) );
+                return;
+            case LISTSXP:
+            case LANGSXP:
+                // Pairlists are hashed element by element with their tags
+                for ( SEXP node = x; node != R_NilValue; node = CDR( node ) ){
+                    object( TAG( node ) );
+                    object( CAR( node ) );
+                }
+                word( 0 );
+                break;
+            case LGLSXP:
+            case INTSXP: {
+                R_xlen_t n = XLENGTH( x );
+                word( n );
+                const int* values = type == LGLSXP ? LOGICAL( x ) : INTEGER( x );
+                for ( R_xlen_t i = 0; i < n; i ++ ) word( radix_key( values[i] ) );
+                break;
+            }
+            case REALSXP: {
+                R_xlen_t n = XLENGTH( x );
+                word( n );
+                const double* values = REAL( x );
+                for ( R_xlen_t i = 0; i < n; i ++ ) word( radix_key( values[i] ) );
+                break;
+            }
+            case CPLXSXP: {
+                R_xlen_t n = XLENGTH( x );
+                word( n );
+                const Rcomplex* values = COMPLEX( x );
+                for ( R_xlen_t i = 0; i < n; i ++ ){
+                    word( radix_key( values[i].r ) );
+                    word( radix_key( values[i].i ) );
+                }
+                break;
+            }
+            case STRSXP: {
+                R_xlen_t n = XLENGTH( x );
+                word( n );
+                for ( R_xlen_t i = 0; i < n; i ++ ) string( STRING_ELT( x, i ) );
+                break;
+            }
+            case VECSXP:
+            case EXPRSXP: {
+                R_xlen_t n = XLENGTH( x );
+                word( n );
+                for ( R_xlen_t i = 0; i < n; i ++ ) object( VECTOR_ELT( x, i ) );
+                break;
+            }
+            case RAWSXP:
+                bytes( (const char*) RAW( x ), XLENGTH( x ) );
+                break;
+            default:
+                stop( "Objects of type '%s' cannot be hashed.", Rf_type2char( type ) );
+        }
+
+        object( ATTRIB( x ) );
+    }
+};
+
+// [[Rcpp::export]]
+String CAB_cpp_hash( SEXP x ){
+    stable_hash hash;
+    hash.object( x );
+    char hex[33];
+    std::snprintf( hex, sizeof( hex ), "%016llx%016llx", (unsigned long long) hash.h1, (unsigned long long) hash.h2 );
+    return( String( hex ) );
+}
@@ -1,4 +1,5 @@
 #include <Rcpp.h>
+#include "CAB_cpp_radix.h"
 using namespace Rcpp;
 
 // This is a simple example of exporting a C++ function to R. You can
@@ -14,7 +15,14 @@ using namespace Rcpp;
 // [[Rcpp::export]]
 NumericMatrix CAB_cpp_indicator_matrix( NumericVector x ){
 
-    NumericVector unique_x = sort_unique(x);
+    std::vector<uint64_t> keys, unique_keys;
+    std::vector<int> lengths;
+    radix_sorted_keys( x.begin(), x.length(), keys );
+    radix_runs( keys, unique_keys, lengths );
+    NumericVector unique_x( unique_keys.size() );
+    for ( int col = 0; col < unique_x.length(); col ++ ){
+        unique_x[col] = radix_value( unique_keys[col] );
+    }
     int unique_length = unique_x.length();
     int x_length = x.length();
 
@@ -1,27 +1,172 @@
 #include <Rcpp.h>
+#include <cmath>
+#include <cstring>
 using namespace Rcpp;
 
-// This is a simple example of exporting a C++ function to R. You can
-// source this function into an R session using the Rcpp::sourceCpp
-// function (or via the Source button on the editor toolbar). Learn
-// more about Rcpp at:
-//
-//   http://www.rcpp.org/
-//   http://adv-r.had.co.nz/Rcpp.html
-//   http://gallery.rcpp.org/
-//
+// Conversion between integers and their binary strings, least significant bit first.
+// Each integer is split a byte at a time with lookup tables of the 8 bits of every byte, so a
+// column of the result is filled by copying at most four table rows.
+
+// bits_of_byte[x][b] is bit b of x
+template <typename T>
+static const T* byte_table(){
+    static T table[256][8];
+    static bool filled = false;
+    if ( !filled ){
+        for ( int x = 0; x < 256; x ++ ){
+            for ( int b = 0; b < 8; b ++ ){
+                table[x][b] = ( x >> b ) & 1;
+            }
+        }
+        filled = true;
+    }
+    return( &table[0][0] );
+}
+
+static void check_bits( int bits ){
+    if ( bits < 1 || bits > 31 ){
+        stop( "'digits' must be between 1 and 31." );
+    }
+}
+
+// Integers as unsigned words, stopping on values that do not fit in bits
+static std::vector<unsigned int> checked_words( NumericVector integers, int bits ){
+    int n = integers.length();
+    double max_value = std::ldexp( 1.0, bits );
+    std::vector<unsigned int> words( n );
+    for ( int i = 0; i < n; i ++ ){
+        double x = integers[i];
+        if ( ISNAN(x) ){
+            stop( "Cannot convert NA to binary." );
+        }
+        if ( x < 0 ){
+            stop( "Cannot convert negative integers to binary. Found %g at position %d.", x, i + 1 );
+        }
+        if ( x >= max_value ){
+            stop( "%g at position %d does not fit in %d binary digits.", x, i + 1, bits );
+        }
+        if ( x != std::floor(x) ){
+            stop( "%g at position %d is not an integer.", x, i + 1 );
+        }
+        words[i] = (unsigned int) x;
+    }
+    return( words );
+}
+
+template <typename T>
+static void unpack_words( const std::vector<unsigned int>& words, int bits, T* out ){
+    const T* table = byte_table<T>();
+    int n = words.size();
+    for ( int i = 0; i < n; i ++ ){
+        T* column = out + (size_t) i * bits;
+        unsigned int word = words[i];
+        for ( int b = 0; b < bits; b += 8 ){
+            int width = bits - b < 8 ? bits - b : 8;
+            std::memcpy( column + b, table + 8 * ( ( word >> b ) & 0xFF ), width * sizeof(T) );
+        }
+    }
+}
+
+// format: 0 = integer matrix, 1 = raw matrix, 2 = packed bit planes
+// [[Rcpp::export]]
+SEXP CAB_cpp_int2bin( int bits, NumericVector integers, int format ){
+
+    check_bits( bits );
+    std::vector<unsigned int> words = checked_words( integers, bits );
+    int n = words.size();
+
+    if ( format == 0 ){
+        IntegerMatrix binaries( bits, n );
+        unpack_words<int>( words, bits, INTEGER(binaries) );
+        return( binaries );
+    }
+    if ( format == 1 ){
+        RawMatrix binaries( bits, n );
+        unpack_words<Rbyte>( words, bits, RAW(binaries) );
+        return( binaries );
+    }
+
+    // Bit plane b holds bit b of 32 organisms per word: bit j of word w is organism 32 * w + j
+    int n_words = ( n + 31 ) / 32;
+    IntegerMatrix planes( bits, n_words );
+    unsigned int* plane_words = (unsigned int*) INTEGER(planes);
+    for ( int w = 0; w < n_words; w ++ ){
+        int first = 32 * w;
+        int last = first + 32 < n ? first + 32 : n;
+        for ( int b = 0; b < bits; b ++ ){
+            unsigned int plane = 0;
+            for ( int i = first; i < last; i ++ ){
+                plane |= ( ( words[i] >> b ) & 1u ) << ( i - first );
+            }
+            plane_words[ (size_t) w * bits + b ] = plane;
+        }
+    }
+    planes.attr( "organisms" ) = n;
+    return( planes );
+}
+
+template <typename T>
+static void pack_columns( const T* binaries, int bits, int n, int* out ){
+    for ( int i = 0; i < n; i ++ ){
+        const T* column = binaries + (size_t) i * bits;
+        unsigned int word = 0;
+        for ( int b = 0; b < bits; b ++ ){
+            if ( column[b] != 0 && column[b] != 1 ){
+                stop( "Binary digits must be 0 or 1. Found another value in column %d.", i + 1 );
+            }
+            word |= (unsigned int) column[b] << b;
+        }
+        out[i] = word;
+    }
+}
+
+// [[Rcpp::export]]
+IntegerVector CAB_cpp_bin2int( SEXP binaries, int bits ){
+
+    check_bits( bits );
+    int length = Rf_length( binaries );
+    if ( length % bits != 0 ){
+        stop( "The number of binary digits is not a multiple of 'digits'." );
+    }
+    int n = length / bits;
+    IntegerVector integers( n );
+
+    switch( TYPEOF( binaries ) ){
+        case INTSXP:
+        case LGLSXP:
+            pack_columns<int>( INTEGER(binaries), bits, n, INTEGER(integers) );
+            break;
+        case RAWSXP:
+            pack_columns<Rbyte>( RAW(binaries), bits, n, INTEGER(integers) );
+            break;
+        case REALSXP:
+            pack_columns<double>( REAL(binaries), bits, n, INTEGER(integers) );
+            break;
+        default:
+            stop( "Binary digits must be integer, logical, numeric or raw." );
+    }
+    return( integers );
+}
 
 // [[Rcpp::export]]
-IntegerVector CAB_cpp_int2bin( int bits, IntegerVector n ){
-    IntegerMatrix stack(bits, n.length() );
-    for ( int integer_n = 0; integer_n < n.length(); integer_n++ ){
-        int temp_n = n[ integer_n ];
-        int i = 0;
-        while ( ( temp_n != 0 )){
-            int remainder = temp_n % 2;
-            stack(i++, integer_n) = remainder;
-            temp_n /= 2;
-        }
-    }
-    return( stack );
+IntegerVector CAB_cpp_unpack_bit_planes( IntegerMatrix planes, int n ){
+
+    int bits = planes.nrow();
+    check_bits( bits );
+    if ( planes.ncol() != ( n + 31 ) / 32 ){
+        stop( "The number of bit plane words does not match the number of organisms." );
+    }
+
+    const unsigned int* plane_words = (const unsigned int*) INTEGER(planes);
+    IntegerVector integers( n );
+    for ( int i = 0; i < n; i ++ ){
+        const unsigned int* column = plane_words + (size_t) ( i / 32 ) * bits;
+        int j = i % 32;
+        unsigned int word = 0;
+        for ( int b = 0; b < bits; b ++ ){
+            word |= ( ( column[b] >> j ) & 1u ) << b;
+        }
+        integers[i] = word;
+    }
+    return( integers );
 }
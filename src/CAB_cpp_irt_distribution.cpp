@@ -0,0 +1,110 @@
+#include <Rcpp.h>
+#include "CAB_cpp_log_histogram.h"
+#include "CAB_cpp_event_record.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+using namespace Rcpp;
+
+// Adds the IxxIs of each label in one session to the histograms of the labels, without keeping the intervals.
+// codes[i] is the label of row i from 0, -2 for a break event and -1 for anything else. An IxxI is counted,
+// as in compute_ixxi_FER_breaks, when no break event comes between the two events of the label.
+// counts has the histograms of the labels one after the other. The times are doubles or integer ticks; the
+// intervals are taken in the units of the times and are time_scale units of time long. Events with missing
+// times are skipped.
+template< typename Time >
+static void add_ixxi( const log_histogram& histogram, const Time* times, double time_scale, const int* codes, int n_rows, int n_labels, double* counts ){
+
+    std::vector<Time> last( n_labels );
+    std::vector<char> got_last( n_labels, 0 );
+
+    for ( int i = 0; i < n_rows; i ++ ){
+        int code = codes[i];
+        if ( code == -1 ) continue;
+        if ( code == -2 ){
+            std::fill( got_last.begin(), got_last.end(), 0 );
+            continue;
+        }
+        if ( missing_time( times[i] ) ) continue;
+        if ( got_last[ code ] ){
+            histogram.add( ( times[i] - last[ code ] ) * time_scale, counts + code * histogram.size() );
+        }
+        last[ code ] = times[i];
+        got_last[ code ] = 1;
+    }
+}
+
+// groups[s] is the group of session s from 0. Returns an array of counts with dim bins x labels x groups.
+// time_scale is the length of a tick for sessions with integer ticks, and 1 for times in doubles.
+// [[Rcpp::export]]
+NumericVector CAB_cpp_irt_histograms( List sessions, CharacterVector labels, CharacterVector break_events, IntegerVector groups, int n_groups, double lower, double upper, int bins_per_decade, double time_scale = 1 ){
+
+    if ( !( lower > 0 ) || !( upper > lower ) ) stop( "'lower' must be positive and less than 'upper'" );
+    if ( bins_per_decade < 1 ) stop( "'bins_per_decade' must be at least 1" );
+
+    int n_sessions = sessions.length();
+    int n_labels = labels.length();
+    log_histogram histogram( lower, upper, bins_per_decade );
+    int group_size = n_labels * histogram.size();
+
+    // Everything that touches R happens here, before the threads start
+    std::vector<NumericVector> times( n_sessions );
+    std::vector<const double*> time_pointers( n_sessions, (const double*) NULL );
+    std::vector<const int*> tick_pointers( n_sessions, (const int*) NULL );
+    std::vector< std::vector<int> > codes( n_sessions );
+    for ( int s = 0; s < n_sessions; s ++ ){
+        if ( groups[s] < 0 || groups[s] >= n_groups ) stop( "Session %d has no group.", s + 1 );
+        DataFrame data = as<DataFrame>( sessions[s] );
+        SEXP time = data["time"];
+        if ( TYPEOF( time ) == INTSXP ){
+            tick_pointers[s] = INTEGER( time );
+        }
+        else{
+            times[s] = time;
+            time_pointers[s] = times[s].begin();
+        }
+        CharacterVector events = data["event"];
+        // match() indexes from 1, subtract 1
+        IntegerVector matched = match( events, labels );
+        IntegerVector breaking = match( events, break_events );
+
+        codes[s].resize( matched.length() );
+        for ( int i = 0; i < matched.length(); i ++ ){
+            if ( matched[i] != NA_INTEGER ) codes[s][i] = matched[i] - 1;
+            else if ( breaking[i] != NA_INTEGER ) codes[s][i] = -2;
+            else codes[s][i] = -1;
+        }
+    }
+    std::vector<int> session_group( groups.begin(), groups.end() );
+
+    // Each thread fills histograms of its own and they are merged at the end
+    std::vector<double> counts( (size_t) group_size * n_groups, 0 );
+    #pragma omp parallel
+    {
+        std::vector<double> thread_counts( counts.size(), 0 );
+
+        #pragma omp for schedule(dynamic)
+        for ( int s = 0; s < n_sessions; s ++ ){
+            double* session_counts = &thread_counts[ (size_t) session_group[s] * group_size ];
+            if ( tick_pointers[s] ){
+                add_ixxi( histogram, tick_pointers[s], time_scale, codes[s].data(), (int) codes[s].size(), n_labels, session_counts );
+            }
+            else{
+                add_ixxi( histogram, time_pointers[s], time_scale, codes[s].data(), (int) codes[s].size(), n_labels, session_counts );
+            }
+        }
+
+        #pragma omp critical
+        histogram.merge( thread_counts.data(), counts.data(), n_labels * n_groups );
+    }
+
+    NumericVector result( counts.begin(), counts.end() );
+    result.attr( "dim" ) = IntegerVector::create( histogram.size(), n_labels, n_groups );
+
+    NumericVector edges( histogram.n_bins + 1 );
+    for ( int k = 0; k <= histogram.n_bins; k ++ ){
+        edges[k] = histogram.edge( k );
+    }
+    result.attr( "edges" ) = edges;
+    return( result );
+}
@@ -1,6 +1,18 @@
 #include <Rcpp.h>
+#include <climits>
+#include "CAB_cpp_event_record.h"
+#include "CAB_cpp_arena.h"
 using namespace Rcpp;
 
+// Intervals are collected in scratch memory and copied out once, with x_offset added
+static NumericVector offset_intervals( const scratch_vector<double>& intervals, double x_offset ){
+    NumericVector result( intervals.size() );
+    for ( size_t j = 0; j < intervals.size(); j ++ ){
+        result[j] = intervals[j] + x_offset;
+    }
+    return( result );
+}
+
 // [[Rcpp::export]]
 NumericVector compute_ixyi_FER( List data, CharacterVector x_event, CharacterVector y_event, double x_offset ){
 
@@ -11,7 +23,10 @@ NumericVector compute_ixyi_FER( List data, CharacterVector x_event, CharacterVec
     double y_time = 0;
     int i = 0;
 
-    std::vector<double> ixyi(0);
+    scratch_scope scope;
+    scratch_vector<double> ixyi;
+    // Every interval after the first needs an x row and a y row of its own
+    ixyi.reserve( times.length() / 2 + 1 );
 
     // Get the first x_event time
     for ( ; i < times.length(); i ++ ){
@@ -38,13 +53,7 @@ NumericVector compute_ixyi_FER( List data, CharacterVector x_event, CharacterVec
         }
     }
 
-    if ( x_offset != 0 ){
-       for ( int j = 0; j < ixyi.size(); j ++ ){
-            ixyi[j] += x_offset;
-        }
-    }
-
-    return( wrap( ixyi ) );
+    return( offset_intervals( ixyi, x_offset ) );
 }
 
 // [[Rcpp::export]]
@@ -58,7 +67,10 @@ NumericVector compute_ixyi_FER_breaks( List data, CharacterVector x_event, Chara
     double y_time = 0;
     int i = 0;
 
-    std::vector<double> ixyi(0);
+    scratch_scope scope;
+    scratch_vector<double> ixyi;
+    // Every interval after the first needs an x row and a y row of its own
+    ixyi.reserve( times.length() / 2 + 1 );
 
     // Get the first x_event time
     for ( ; i < times.length(); i ++ ){
@@ -89,13 +101,7 @@ NumericVector compute_ixyi_FER_breaks( List data, CharacterVector x_event, Chara
         }
     }
 
-    if ( x_offset != 0 ){
-       for ( int j = 0; j < ixyi.size(); j ++ ){
-            ixyi[j] += x_offset;
-        }
-    }
-
-    return( wrap( ixyi ) );
+    return( offset_intervals( ixyi, x_offset ) );
 }
 
 // [[Rcpp::export]]
@@ -108,7 +114,10 @@ NumericVector compute_ixxi_FER( List data, CharacterVector x_event, double x_off
     double x_time2 = 0;
     int i = 0;
 
-    std::vector<double> ixxi(0);
+    scratch_scope scope;
+    scratch_vector<double> ixxi;
+    // Every row ends at most one interval
+    ixxi.reserve( times.length() );
 
     // Get the first x_event time
     for ( ; i < times.length(); i ++ ){
@@ -130,13 +139,7 @@ NumericVector compute_ixxi_FER( List data, CharacterVector x_event, double x_off
         }
     }
 
-    if ( x_offset != 0 ){
-       for ( int j = 0; j < ixxi.size(); j ++ ){
-            ixxi[j] += x_offset;
-        }
-    }
-
-    return( wrap( ixxi ) );
+    return( offset_intervals( ixxi, x_offset ) );
 }
 
 // [[Rcpp::export]]
@@ -150,7 +153,10 @@ NumericVector compute_ixxi_FER_breaks( List data, CharacterVector x_event, Chara
     double x_time2 = 0;
     int i = 0;
 
-    std::vector<double> ixxi(0);
+    scratch_scope scope;
+    scratch_vector<double> ixxi;
+    // Every row ends at most one interval
+    ixxi.reserve( times.length() );
 
     // Get the first x_event time
     for ( ; i < times.length(); i ++ ){
@@ -178,13 +184,157 @@ NumericVector compute_ixxi_FER_breaks( List data, CharacterVector x_event, Chara
         }
     }
 
-    if ( x_offset != 0 ){
-       for ( int j = 0; j < ixxi.size(); j ++ ){
-            ixxi[j] += x_offset;
+    return( offset_intervals( ixxi, x_offset ) );
+}
+
+// The *_indexed kernels give the same intervals as the *_FER kernels, but only visit the rows of
+// x_event, y_event and break_events through the label index of the record (see event_index()).
+
+static std::vector<int> indexed_rows( CharacterVector labels, IntegerVector offsets, IntegerVector rows, CharacterVector events ){
+    IntegerVector codes = match( events, labels ) - 1;
+    for ( int i = 0; i < codes.length(); i ++ ){
+        if ( codes[i] < 0 ) codes[i] = -1;
+    }
+    std::vector<int> label_rows(0);
+    gather_label_rows( offsets.begin(), rows.begin(), codes.begin(), codes.length(), label_rows );
+    return( label_rows );
+}
+
+// The times of a record are integer ticks or doubles. The indexed kernels read them in place, so an
+// integer time column is not copied to doubles, and give the intervals as doubles. NA ticks become NA.
+static inline double time_value( double time ){
+    return( time );
+}
+
+static inline double time_value( int time ){
+    return( time == NA_INTEGER ? NA_REAL : (double) time );
+}
+
+static void check_times( SEXP times ){
+    if ( TYPEOF( times ) != INTSXP && TYPEOF( times ) != REALSXP ) stop( "'times' must be an integer or double vector." );
+}
+
+template< typename Time >
+static void ixyi_indexed( const Time* times, const std::vector<int>& x_rows, const std::vector<int>& y_rows, const std::vector<int>& break_rows, scratch_vector<double>& ixyi ){
+
+    int n_x = x_rows.size();
+    int n_y = y_rows.size();
+    int n_break = break_rows.size();
+
+    if ( n_x == 0 ) return;
+    ixyi.reserve( std::min( n_x, n_y ) );
+
+    // Start at the first x_event
+    double x_time = time_value( times[ x_rows[0] ] );
+    bool got_x = true;
+    int x = 0;
+    int y = 0;
+    int b = 0;
+    for ( ; y < n_y && y_rows[y] < x_rows[0]; y ++ ){
+    }
+    for ( ; b < n_break && break_rows[b] < x_rows[0]; b ++ ){
+    }
+
+    // Walk the x, y and break rows in record order
+    while ( true ){
+        int row = INT_MAX;
+        if ( x < n_x ) row = std::min( row, x_rows[x] );
+        if ( y < n_y ) row = std::min( row, y_rows[y] );
+        if ( b < n_break ) row = std::min( row, break_rows[b] );
+        if ( row == INT_MAX ) break;
+
+        bool is_x = x < n_x && x_rows[x] == row;
+        bool is_y = y < n_y && y_rows[y] == row;
+        bool is_break = b < n_break && break_rows[b] == row;
+        x += is_x;
+        y += is_y;
+        b += is_break;
+
+        if ( got_x ){
+            if ( is_y ){
+                ixyi.push_back( time_value( times[row] ) - x_time );
+                got_x = false;
+            }
+            else if ( is_break ){
+                got_x = false;
+            }
+        }
+        else if ( is_x ){
+            x_time = time_value( times[row] );
+            got_x = true;
+        }
+    }
+}
+
+template< typename Time >
+static void ixxi_indexed( const Time* times, const std::vector<int>& x_rows, const std::vector<int>& break_rows, scratch_vector<double>& ixxi ){
+
+    int n_x = x_rows.size();
+    int n_break = break_rows.size();
+
+    if ( n_x <= 1 ) return;
+    ixxi.reserve( n_x - 1 );
+
+    // Start after the first x_event
+    double x_time1 = time_value( times[ x_rows[0] ] );
+    bool got_x1 = true;
+    int x = 1;
+    int b = 0;
+    for ( ; b < n_break && break_rows[b] <= x_rows[0]; b ++ ){
+    }
+
+    while ( true ){
+        int row = INT_MAX;
+        if ( x < n_x ) row = std::min( row, x_rows[x] );
+        if ( b < n_break ) row = std::min( row, break_rows[b] );
+        if ( row == INT_MAX ) break;
+
+        bool is_x = x < n_x && x_rows[x] == row;
+        bool is_break = b < n_break && break_rows[b] == row;
+        x += is_x;
+        b += is_break;
+
+        if ( got_x1 ){
+            if ( is_x ){
+                ixxi.push_back( time_value( times[row] ) - x_time1 );
+                x_time1 = time_value( times[row] );
+            }
+            else if ( is_break ){
+                got_x1 = false;
+            }
+        }
+        else if ( is_x ){
+            x_time1 = time_value( times[row] );
+            got_x1 = true;
         }
     }
+}
 
-    return( wrap( ixxi ) );
+// [[Rcpp::export]]
+NumericVector compute_ixyi_indexed( SEXP times, CharacterVector labels, IntegerVector offsets, IntegerVector rows, CharacterVector x_event, CharacterVector y_event, CharacterVector break_events, double x_offset ){
+
+    check_times( times );
+    std::vector<int> x_rows = indexed_rows( labels, offsets, rows, x_event );
+    std::vector<int> y_rows = indexed_rows( labels, offsets, rows, y_event );
+    std::vector<int> break_rows = indexed_rows( labels, offsets, rows, break_events );
+
+    scratch_scope scope;
+    scratch_vector<double> ixyi;
+    if ( TYPEOF( times ) == INTSXP ) ixyi_indexed( INTEGER( times ), x_rows, y_rows, break_rows, ixyi );
+    else ixyi_indexed( REAL( times ), x_rows, y_rows, break_rows, ixyi );
+    return( offset_intervals( ixyi, x_offset ) );
 }
 
+// [[Rcpp::export]]
+NumericVector compute_ixxi_indexed( SEXP times, CharacterVector labels, IntegerVector offsets, IntegerVector rows, CharacterVector x_event, CharacterVector break_events, double x_offset ){
+
+    check_times( times );
+    std::vector<int> x_rows = indexed_rows( labels, offsets, rows, x_event );
+    std::vector<int> break_rows = indexed_rows( labels, offsets, rows, break_events );
 
+    scratch_scope scope;
+    scratch_vector<double> ixxi;
+    if ( TYPEOF( times ) == INTSXP ) ixxi_indexed( INTEGER( times ), x_rows, break_rows, ixxi );
+    else ixxi_indexed( REAL( times ), x_rows, break_rows, ixxi );
+    return( offset_intervals( ixxi, x_offset ) );
+}
@@ -1,34 +1,33 @@
-//[[Rcpp:depends(RccpArmadillo)]]
-
-#include <RcppArmadillo.h>
+#include <Rcpp.h>
+#include "CAB_cpp_radix.h"
+#include "CAB_cpp_statistics.h"
+using namespace Rcpp;
 
 //'@export ks
 //'@rdname ks
 // [[Rcpp::export]]
-double ks( arma::colvec sample_1, arma::colvec sample_2 ){
+double ks( NumericVector sample_1, NumericVector sample_2 ){
 
-    double n1 = sample_1.n_rows;
-    double n2 = sample_2.n_rows;
+    int n1 = sample_1.length();
+    int n2 = sample_2.length();
 
-    if ( n1 < 1 | n2 < 1 ){
+    if ( n1 < 1 || n2 < 1 ){
         return( R_PosInf );
     }
-
-    arma::colvec all_samples = arma::join_cols( sample_1, sample_2 );
-    arma::uvec sorted = arma::sort_index( all_samples );
-
-    arma::colvec sorted_diff = arma::diff( all_samples(sorted) );
-
-    all_samples.fill( -1/n2 );
-    all_samples( arma::find( sorted <= n1-1 ) ).ones();
-    all_samples.replace( 1, 1/n1 );
-
-    arma::colvec cum_sum = arma::cumsum( all_samples );
-
-    if ( any( sorted_diff == 0 ) ){
-        cum_sum( arma::find( sorted_diff == 0 ) ).zeros();
-        cum_sum( n1 + n2 - 1 ) = 0;
+    for ( int i = 0; i < n1; i ++ ){
+        if ( ISNAN( sample_1[i] ) ) stop( "'sample_1' must not have missing values." );
     }
+    for ( int j = 0; j < n2; j ++ ){
+        if ( ISNAN( sample_2[j] ) ) stop( "'sample_2' must not have missing values." );
+    }
+
+    // The samples are radix sorted as keys, which sort in the same order as the values
+    std::vector<uint64_t> keys_1, keys_2;
+    radix_sorted_keys( sample_1.begin(), n1, keys_1 );
+    radix_sorted_keys( sample_2.begin(), n2, keys_2 );
+    std::vector<double> sorted_1( n1 ), sorted_2( n2 );
+    for ( int i = 0; i < n1; i ++ ) sorted_1[i] = radix_value( keys_1[i] );
+    for ( int j = 0; j < n2; j ++ ) sorted_2[j] = radix_value( keys_2[j] );
 
-    return( max(abs( cum_sum ) ) );
+    return( ks_sorted( &sorted_1[0], n1, &sorted_2[0], n2 ) );
 }
@@ -57,27 +57,48 @@ List CAB_cpp_local_times_formal_event_record( DataFrame data, String event, Stri
     return( return_list );
 }
 
-// [[Rcpp::export]]
-List CAB_cpp_local_binning( NumericVector local_times, NumericVector visit_lengths, int max_bin, double bin_resolution ){
-    NumericVector copy_visit_lengths = visit_lengths / bin_resolution;
+// Bins the local times and visit lengths by width, in ticks or in units of time. A time is in bin k if
+// time / width, truncated toward 0, is k. A visit reaches every bin up to the bin of its length.
+template< typename Time >
+static void local_binning( const Time* local_times, int n_times, const Time* visit_lengths, int n_visits, Time width, int max_bin, int* visit_bins, int* response_bins ){
+
+    if ( max_bin < 0 ) return;
+
+    // The visits that reach bin k are those that end in bin k or later
+    std::vector<int> ends( max_bin + 1, 0 );
+    for ( int i = 0; i < n_visits; i ++ ){
+        if ( !( visit_lengths[i] >= 0 ) ) continue;
+        Time bin = visit_lengths[i] / width;
+        ends[ bin > max_bin ? max_bin : (int) bin ] ++;
+    }
+    int reaching = 0;
+    for ( int k = max_bin; k >= 0; k -- ){
+        reaching += ends[k];
+        visit_bins[k] = reaching;
+    }
 
-    NumericVector copy_local_times =  local_times / bin_resolution;
+    for ( int i = 0; i < n_times; i ++ ){
+        Time bin = local_times[i] / width;
+        if ( !( bin > -1 ) || bin > max_bin ) continue;
+        response_bins[ (int) bin ] ++;
+    }
+}
+
+// Integer ticks are binned with integer division when bin_resolution is a whole number of ticks
+// [[Rcpp::export]]
+List CAB_cpp_local_binning( SEXP local_times, SEXP visit_lengths, int max_bin, double bin_resolution ){
 
     IntegerVector visit_bins( max_bin + 1 );
     IntegerVector response_bins( max_bin + 1 );
 
-    IntegerVector reference_time_bins = wrap( seq( 0, max_bin ) );
-    LogicalVector temp_indicator = reference_time_bins == -1;
-
-    for ( int i = 0; i < copy_visit_lengths.length(); i ++ ){
-        temp_indicator = reference_time_bins <= copy_visit_lengths[i];
-        visit_bins += as<IntegerVector>(temp_indicator);
-    }
-
-    IntegerVector int_local_times = as<IntegerVector>(copy_local_times);
-
-    for ( int i = 0; i < copy_local_times.length(); i ++ ){
-        if ( int_local_times[i] <= max_bin ) response_bins[int_local_times[i]] ++;
+    if ( TYPEOF( local_times ) == INTSXP && TYPEOF( visit_lengths ) == INTSXP && bin_resolution >= 1 && bin_resolution == floor( bin_resolution ) ){
+        IntegerVector ticks( local_times );
+        IntegerVector visit_ticks( visit_lengths );
+        local_binning<int>( ticks.begin(), ticks.length(), visit_ticks.begin(), visit_ticks.length(), (int) bin_resolution, max_bin, visit_bins.begin(), response_bins.begin() );
+    } else{
+        NumericVector times( local_times );
+        NumericVector visit_times( visit_lengths );
+        local_binning<double>( times.begin(), times.length(), visit_times.begin(), visit_times.length(), bin_resolution, max_bin, visit_bins.begin(), response_bins.begin() );
     }
 
     List return_list = List::create(Named("visit_bins") = visit_bins, Named("response_bins") = response_bins );
@@ -0,0 +1,69 @@
+#ifndef CAB_CPP_LOG_HISTOGRAM_H
+#define CAB_CPP_LOG_HISTOGRAM_H
+
+#include <vector>
+#include <cmath>
+
+// Histograms of positive values in bins of equal width on the log scale.
+// A histogram takes the same memory however many values it holds, and two histograms with the same bins
+// merge by adding their counts, so the histograms of threads, sessions and conditions can be combined in
+// any order with the same result. Any quantile is within one bin, a factor of 10^( 1 / bins_per_decade ),
+// of the true quantile.
+//
+// Bin k, from 1 to n_bins, is [ lower * 10^( ( k - 1 ) / bins_per_decade ), lower * 10^( k / bins_per_decade ) ).
+// Bin 0 has the values below lower, and bin n_bins + 1 those at or above the upper edge of bin n_bins.
+// Counts are doubles so that they can be added past the range of an int.
+
+class log_histogram {
+public:
+    double lower;
+    int bins_per_decade;
+    int n_bins;
+
+    log_histogram( double lower, double upper, int bins_per_decade ) :
+        lower( lower ), bins_per_decade( bins_per_decade ),
+        n_bins( (int) std::ceil( std::log10( upper / lower ) * bins_per_decade - 1e-9 ) ),
+        log_lower( std::log( lower ) ), scale( bins_per_decade / std::log( 10.0 ) ), edges( n_bins + 1 ) {
+        for ( int k = 0; k <= n_bins; k ++ ){
+            edges[k] = lower * std::pow( 10.0, (double) k / bins_per_decade );
+        }
+    }
+
+    int size() const {
+        return( n_bins + 2 );
+    }
+
+    int bin( double x ) const {
+        if ( !( x >= lower ) ) return( 0 );
+        double position = ( std::log( x ) - log_lower ) * scale;
+        if ( position >= n_bins + 1 ) return( n_bins + 1 );
+        // The logarithm can put values next to an edge on the wrong side of it
+        int k = (int) position;
+        if ( k < n_bins && x >= edges[ k + 1 ] ) k ++;
+        else if ( k > 0 && x < edges[k] ) k --;
+        return( k + 1 );
+    }
+
+    // Upper edge of bin k, from 0 to n_bins
+    double edge( int k ) const {
+        return( edges[k] );
+    }
+
+    // counts has size() elements
+    void add( double x, double* counts ) const {
+        if ( x == x ) counts[ bin( x ) ] += 1;
+    }
+
+    // Adds n_histograms histograms, stored one after the other, to those in counts
+    void merge( const double* from, double* counts, int n_histograms = 1 ) const {
+        size_t n = (size_t) n_histograms * size();
+        for ( size_t k = 0; k < n; k ++ ) counts[k] += from[k];
+    }
+
+private:
+    double log_lower;
+    double scale;
+    std::vector<double> edges;
+};
+
+#endif
@@ -0,0 +1,63 @@
+#include <Rcpp.h>
+#include "CAB_cpp_profile.h"
+using namespace Rcpp;
+
+#ifdef CAB_PROFILE
+profile_counters cab_profile[ PROFILE_N_STAGES ];
+thread_local int cab_profile_stage = -1;
+#endif
+
+// [[Rcpp::export]]
+DataFrame CAB_cpp_profile_table(){
+
+    CharacterVector stage = CharacterVector::create( "emission", "fitness", "selection", "recombination", "mutation", "recording" );
+    NumericVector calls( PROFILE_N_STAGES );
+    NumericVector cycles( PROFILE_N_STAGES );
+    NumericVector seconds( PROFILE_N_STAGES );
+    NumericVector allocations( PROFILE_N_STAGES );
+
+#ifdef CAB_PROFILE
+    for ( int i = 0; i < PROFILE_N_STAGES; i ++ ){
+        calls[i] = cab_profile[i].calls;
+        cycles[i] = cab_profile[i].cycles;
+        seconds[i] = cab_profile[i].nanoseconds * 1e-9;
+        allocations[i] = cab_profile[i].allocations;
+    }
+#endif
+
+    return( DataFrame::create( Named("stage") = stage, Named("calls") = calls, Named("cycles") = cycles,
+        Named("seconds") = seconds, Named("allocations") = allocations, Named("stringsAsFactors") = false ) );
+}
+
+// [[Rcpp::export]]
+bool CAB_cpp_profile_reset(){
+#ifdef CAB_PROFILE
+    for ( int i = 0; i < PROFILE_N_STAGES; i ++ ){
+        cab_profile[i] = profile_counters();
+    }
+    return( true );
+#else
+    return( false );
+#endif
+}
+
+// [[Rcpp::export]]
+bool CAB_cpp_profile_enabled(){
+#ifdef CAB_PROFILE
+    return( true );
+#else
+    return( false );
+#endif
+}
+
+// For stages that run in R. stage counts from 0.
+// [[Rcpp::export]]
+void CAB_cpp_profile_add( int stage, double seconds ){
+#ifdef CAB_PROFILE
+    if ( stage < 0 || stage >= PROFILE_N_STAGES ) stop( "Unknown profiling stage." );
+    #pragma omp atomic
+    cab_profile[stage].calls ++;
+    #pragma omp atomic
+    cab_profile[stage].nanoseconds += seconds * 1e9;
+#endif
+}
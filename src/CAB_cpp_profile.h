@@ -0,0 +1,92 @@
+#ifndef CAB_CPP_PROFILE_H
+#define CAB_CPP_PROFILE_H
+
+// Per-stage counters for the compiled model kernels.
+// They are compiled in only when CAB_PROFILE is defined (see Makevars). Otherwise the macros expand
+// to nothing and the kernels are unchanged. The counters are updated atomically, so profiled code can
+// run on OpenMP threads; the time of stages that run on several threads at once is then summed over
+// the threads. Allocations are counted at one place, scratch_arena::allocate(), and go to the innermost
+// stage open on the thread. Retrieve the counters from R with model_profile().
+
+enum profile_stage {
+    PROFILE_EMISSION,
+    PROFILE_FITNESS,
+    PROFILE_SELECTION,
+    PROFILE_RECOMBINATION,
+    PROFILE_MUTATION,
+    PROFILE_RECORDING,
+    PROFILE_N_STAGES
+};
+
+#ifdef CAB_PROFILE
+
+#include <chrono>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+struct profile_counters {
+    double calls;
+    double cycles;
+    double nanoseconds;
+    double allocations;
+};
+
+extern profile_counters cab_profile[ PROFILE_N_STAGES ];
+
+// The innermost stage open on this thread, or -1
+extern thread_local int cab_profile_stage;
+
+// Time stamp counter where there is one, otherwise the steady clock in nanoseconds
+inline unsigned long long profile_cycles(){
+#if defined(__x86_64__) || defined(__i386__)
+    return( __rdtsc() );
+#else
+    return( std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now().time_since_epoch() ).count() );
+#endif
+}
+
+// Adds the time between construction and destruction to a stage
+class profile_scope {
+public:
+    explicit profile_scope( profile_stage stage ) : stage( stage ), outer( cab_profile_stage ),
+        start_time( std::chrono::steady_clock::now() ), start_cycles( profile_cycles() ){
+        cab_profile_stage = stage;
+        #pragma omp atomic
+        cab_profile[stage].calls ++;
+    }
+    ~profile_scope(){
+        cab_profile_stage = outer;
+        double cycles = profile_cycles() - start_cycles;
+        double nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now() - start_time ).count();
+        #pragma omp atomic
+        cab_profile[stage].cycles += cycles;
+        #pragma omp atomic
+        cab_profile[stage].nanoseconds += nanoseconds;
+    }
+private:
+    profile_stage stage;
+    int outer;
+    std::chrono::steady_clock::time_point start_time;
+    unsigned long long start_cycles;
+};
+
+// Counts an allocation against the innermost open stage
+inline void profile_allocation(){
+    int stage = cab_profile_stage;
+    if ( stage < 0 ) return;
+    #pragma omp atomic
+    cab_profile[stage].allocations ++;
+}
+
+#define CAB_PROFILE_SCOPE( stage ) profile_scope cab_profile_scope_( stage )
+#define CAB_PROFILE_ALLOCATION() profile_allocation()
+
+#else
+
+#define CAB_PROFILE_SCOPE( stage )
+#define CAB_PROFILE_ALLOCATION()
+
+#endif
+
+#endif
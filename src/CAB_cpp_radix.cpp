@@ -0,0 +1,82 @@
+#include <Rcpp.h>
+#include "CAB_cpp_radix.h"
+using namespace Rcpp;
+
+// Radix sort kernels for double and integer vectors. See CAB_cpp_radix.h.
+
+template< int RTYPE >
+static Vector<RTYPE> radix_sort_vector( Vector<RTYPE> x ){
+    typedef typename traits::storage_type<RTYPE>::type Value;
+    std::vector< typename radix_key_type<Value>::type > keys;
+    radix_sorted_keys( x.begin(), x.length(), keys );
+    Vector<RTYPE> sorted( keys.size() );
+    for ( size_t i = 0; i < keys.size(); i ++ ){
+        sorted[i] = radix_value( keys[i] );
+    }
+    return( sorted );
+}
+
+template< int RTYPE >
+static List radix_rle_vector( Vector<RTYPE> x ){
+    typedef typename traits::storage_type<RTYPE>::type Value;
+    typedef typename radix_key_type<Value>::type Key;
+    std::vector<Key> keys, values;
+    std::vector<int> lengths;
+    radix_sorted_keys( x.begin(), x.length(), keys );
+    radix_runs( keys, values, lengths );
+
+    Vector<RTYPE> unique_values( values.size() );
+    for ( size_t i = 0; i < values.size(); i ++ ){
+        unique_values[i] = radix_value( values[i] );
+    }
+    return( List::create( Named("values") = unique_values, Named("lengths") = IntegerVector( lengths.begin(), lengths.end() ) ) );
+}
+
+static void check_radix_type( SEXP x ){
+    if ( TYPEOF( x ) != REALSXP && TYPEOF( x ) != INTSXP ) stop( "'x' must be a double or integer vector." );
+}
+
+// [[Rcpp::export]]
+SEXP CAB_cpp_radix_sort( SEXP x ){
+    check_radix_type( x );
+    if ( TYPEOF( x ) == INTSXP ) return( radix_sort_vector<INTSXP>( x ) );
+    return( radix_sort_vector<REALSXP>( x ) );
+}
+
+// Counts from 1
+// [[Rcpp::export]]
+IntegerVector CAB_cpp_radix_order( SEXP x ){
+    check_radix_type( x );
+    int n = Rf_length( x );
+    IntegerVector order( n );
+    if ( TYPEOF( x ) == INTSXP ) radix_order( INTEGER( x ), n, order.begin() );
+    else radix_order( REAL( x ), n, order.begin() );
+    for ( int i = 0; i < n; i ++ ) order[i] ++;
+    return( order );
+}
+
+// Sorted unique values
+// [[Rcpp::export]]
+SEXP CAB_cpp_unique( SEXP x ){
+    check_radix_type( x );
+    List runs = TYPEOF( x ) == INTSXP ? radix_rle_vector<INTSXP>( x ) : radix_rle_vector<REALSXP>( x );
+    return( runs["values"] );
+}
+
+// [[Rcpp::export]]
+LogicalVector CAB_cpp_not_duplicated( SEXP x ){
+    check_radix_type( x );
+    int n = Rf_length( x );
+    LogicalVector first( n );
+    if ( TYPEOF( x ) == INTSXP ) radix_first_occurrences( INTEGER( x ), n, first.begin() );
+    else radix_first_occurrences( REAL( x ), n, first.begin() );
+    return( first );
+}
+
+// Sorted unique values and the number of times each occurs
+// [[Rcpp::export]]
+List CAB_cpp_radix_rle( SEXP x ){
+    check_radix_type( x );
+    if ( TYPEOF( x ) == INTSXP ) return( radix_rle_vector<INTSXP>( x ) );
+    return( radix_rle_vector<REALSXP>( x ) );
+}
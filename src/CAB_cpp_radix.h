@@ -0,0 +1,197 @@
+#ifndef CAB_CPP_RADIX_H
+#define CAB_CPP_RADIX_H
+
+#include <vector>
+#include <algorithm>
+#include <cstring>
+#include <stdint.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// Sorting, ordering, unique values, first occurrences and run lengths of doubles and ints by LSD radix sort.
+// Values are mapped to unsigned keys that sort in the same order, and the keys are sorted a byte at a
+// time from the least significant byte, carrying the position of each value with it. Each pass is stable,
+// so values that are equal keep their order. Passes on a byte that is the same for every key are skipped.
+// Long inputs are sorted in parallel: every thread counts the bytes of its own chunk, and the chunks are
+// scattered to places worked out from all the counts, so the result is the same for any number of threads.
+// Nothing in here touches R objects.
+//
+// Doubles sort in numeric order, with -0 equal to 0, then NaN, then R's NA. Ints sort with NA last.
+
+// Inputs at least this long are sorted in parallel
+static const size_t RADIX_PARALLEL_MIN = 1 << 16;
+
+template< typename Value > struct radix_key_type;
+template<> struct radix_key_type<double> { typedef uint64_t type; };
+template<> struct radix_key_type<int> { typedef uint32_t type; };
+
+inline uint64_t radix_key( double x ){
+    // -0 sorts and compares as 0
+    if ( x == 0 ) x = 0;
+    uint64_t bits;
+    std::memcpy( &bits, &x, sizeof( bits ) );
+    if ( x != x ){
+        // R marks NA with 1954 in the low word
+        return( (uint32_t) bits == 1954 ? ~(uint64_t) 0 : ~(uint64_t) 1 );
+    }
+    // Flipping the sign bit of positive values and every bit of negative values orders them as unsigned ints
+    return( bits >> 63 ? ~bits : bits | ( (uint64_t) 1 << 63 ) );
+}
+
+inline double radix_value( uint64_t key ){
+    uint64_t bits;
+    if ( key == ~(uint64_t) 0 ) bits = ( (uint64_t) 0x7FF00000 << 32 ) | 1954;
+    else if ( key == ~(uint64_t) 1 ) bits = (uint64_t) 0x7FF80000 << 32;
+    else bits = key >> 63 ? key & ~( (uint64_t) 1 << 63 ) : ~key;
+    double x;
+    std::memcpy( &x, &bits, sizeof( x ) );
+    return( x );
+}
+
+// NA_INTEGER is the smallest int, so the keys are shifted down by one to wrap it round to the end
+inline uint32_t radix_key( int x ){
+    return( ( (uint32_t) x ^ 0x80000000u ) - 1 );
+}
+
+inline int radix_value( uint32_t key ){
+    return( (int) ( ( key + 1 ) ^ 0x80000000u ) );
+}
+
+// Scatters keys[ first, last ) and their index by byte shift, given where each byte value starts in the output
+template< typename Key >
+inline void radix_scatter( const Key* keys, const int* index, size_t first, size_t last, int shift, size_t* place, Key* keys_out, int* index_out ){
+    for ( size_t i = first; i < last; i ++ ){
+        size_t to = place[ ( keys[i] >> shift ) & 0xFF ] ++;
+        keys_out[ to ] = keys[i];
+        if ( index ) index_out[ to ] = index[i];
+    }
+}
+
+// Sorts keys, and index with them if it is not NULL. The buffers have room for n elements.
+template< typename Key >
+void radix_sort( Key* keys, int* index, size_t n, Key* key_buffer, int* index_buffer ){
+
+    Key* from = keys;
+    Key* to = key_buffer;
+    int* index_from = index;
+    int* index_to = index_buffer;
+
+    int n_threads = 1;
+#ifdef _OPENMP
+    if ( n >= RADIX_PARALLEL_MIN ) n_threads = omp_get_max_threads();
+#endif
+    std::vector<size_t> counts( (size_t) n_threads * 256 );
+
+    for ( int shift = 0; shift < (int) ( 8 * sizeof( Key ) ); shift += 8 ){
+
+        bool trivial = false;
+
+        #pragma omp parallel num_threads( n_threads ) if ( n_threads > 1 )
+        {
+            int t = 0;
+            int used = 1;
+#ifdef _OPENMP
+            t = omp_get_thread_num();
+            used = omp_get_num_threads();
+#endif
+            size_t first = n * t / used;
+            size_t last = n * ( t + 1 ) / used;
+            size_t* count = &counts[ (size_t) t * 256 ];
+            std::fill( count, count + 256, 0 );
+            for ( size_t i = first; i < last; i ++ ){
+                count[ ( from[i] >> shift ) & 0xFF ] ++;
+            }
+
+            #pragma omp barrier
+            #pragma omp single
+            {
+                // Byte value b of thread t goes after every smaller byte value and after b in earlier threads
+                size_t total = 0;
+                for ( int b = 0; b < 256; b ++ ){
+                    size_t in_byte = 0;
+                    for ( int s = 0; s < used; s ++ ){
+                        size_t c = counts[ (size_t) s * 256 + b ];
+                        counts[ (size_t) s * 256 + b ] = total + in_byte;
+                        in_byte += c;
+                    }
+                    if ( in_byte == n ) trivial = true;
+                    total += in_byte;
+                }
+            }
+
+            if ( !trivial ){
+                radix_scatter( from, index_from, first, last, shift, count, to, index_to );
+            }
+        }
+
+        if ( trivial ) continue;
+        std::swap( from, to );
+        std::swap( index_from, index_to );
+    }
+
+    // An odd number of passes leaves the result in the buffers
+    if ( from != keys ){
+        std::memcpy( keys, from, n * sizeof( Key ) );
+        if ( index ) std::memcpy( index, index_from, n * sizeof( int ) );
+    }
+}
+
+// Positions of the values in sorted order, counting from 0. Equal values keep their order.
+template< typename Value >
+void radix_order( const Value* x, size_t n, int* order ){
+    typedef typename radix_key_type<Value>::type Key;
+    std::vector<Key> keys( n ), key_buffer( n );
+    std::vector<int> index_buffer( n );
+    for ( size_t i = 0; i < n; i ++ ){
+        keys[i] = radix_key( x[i] );
+        order[i] = i;
+    }
+    radix_sort( keys.data(), order, n, key_buffer.data(), index_buffer.data() );
+}
+
+// Sorted keys of the values
+template< typename Value, typename Key >
+void radix_sorted_keys( const Value* x, size_t n, std::vector<Key>& keys ){
+    keys.resize( n );
+    std::vector<Key> key_buffer( n );
+    for ( size_t i = 0; i < n; i ++ ){
+        keys[i] = radix_key( x[i] );
+    }
+    radix_sort( keys.data(), (int*) NULL, n, key_buffer.data(), (int*) NULL );
+}
+
+// Each distinct key of sorted keys, and how many times it occurs
+template< typename Key >
+void radix_runs( const std::vector<Key>& keys, std::vector<Key>& values, std::vector<int>& lengths ){
+    values.clear();
+    lengths.clear();
+    for ( size_t i = 0; i < keys.size(); i ++ ){
+        if ( i == 0 || keys[i] != keys[ i - 1 ] ){
+            values.push_back( keys[i] );
+            lengths.push_back( 1 );
+        } else {
+            lengths.back() ++;
+        }
+    }
+}
+
+// first[i] is 1 if no value before x[i] is equal to it. The order is stable, so the first of each run of equal
+// keys is the first occurrence.
+template< typename Value >
+void radix_first_occurrences( const Value* x, size_t n, int* first ){
+    typedef typename radix_key_type<Value>::type Key;
+    std::vector<Key> keys( n ), key_buffer( n );
+    std::vector<int> order( n ), index_buffer( n );
+    for ( size_t i = 0; i < n; i ++ ){
+        keys[i] = radix_key( x[i] );
+        order[i] = i;
+        first[i] = 0;
+    }
+    radix_sort( keys.data(), order.data(), n, key_buffer.data(), index_buffer.data() );
+    for ( size_t i = 0; i < n; i ++ ){
+        if ( i == 0 || keys[i] != keys[ i - 1 ] ) first[ order[i] ] = 1;
+    }
+}
+
+#endif
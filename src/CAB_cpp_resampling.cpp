@@ -0,0 +1,145 @@
+#include <Rcpp.h>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include "CAB_cpp_rng.h"
+#include "CAB_cpp_statistics.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+using namespace Rcpp;
+
+// Resampling without materialising the repeats. Each repeat draws its indices from its own RNG stream
+// into a per-thread buffer, so results do not depend on the number of threads.
+
+// Floyd's algorithm scans the sample for every draw, so it is only used for small samples from large populations.
+static inline bool use_floyd( int n, int sample_size ){
+    return( sample_size <= 64 && n > 64 * sample_size );
+}
+
+static inline void draw_indices( xoshiro256& rng, std::vector<int>& permutation, int n, int sample_size, bool replace, int* out ){
+    if ( replace ){
+        for ( int i = 0; i < sample_size; i ++ ){
+            out[i] = rng.bounded( n );
+        }
+    } else if ( use_floyd( n, sample_size ) ){
+        floyd_sample( rng, n, sample_size, out );
+    } else {
+        partial_fisher_yates( rng, permutation, n, sample_size, out );
+    }
+}
+
+// Quantile of type 7, as in quantile(). Reorders values. probability is in [0,1].
+static inline double quantile_7( double* values, int n, double probability ){
+    double h = ( n - 1 ) * probability;
+    int lower = (int) std::floor( h );
+    std::nth_element( values, values + lower, values + n );
+    double lower_value = values[lower];
+    if ( lower + 1 >= n ) return( lower_value );
+    double upper_value = *std::min_element( values + lower + 1, values + n );
+    return( lower_value + ( h - lower ) * ( upper_value - lower_value ) );
+}
+
+//'@export resample_indices
+//'@rdname CAB_samplers
+// [[Rcpp::export]]
+IntegerMatrix resample_indices( int n, int repeats, int sample_size, bool replace = true ){
+
+    if ( n < 1 || repeats < 0 || sample_size < 0 ){
+        stop( "'n' must be positive and 'repeats' and 'sample_size' must be non-negative." );
+    }
+    if ( !replace && sample_size > n ){
+        stop( "Cannot take a sample larger than the population when 'replace = FALSE'." );
+    }
+
+    IntegerMatrix return_matrix( sample_size, repeats );
+    int* indices = INTEGER( return_matrix );
+    uint64_t seed = seed_from_uniforms( R::unif_rand(), R::unif_rand() );
+
+    #pragma omp parallel
+    {
+        std::vector<int> permutation;
+
+        #pragma omp for schedule(static)
+        for ( int r = 0; r < repeats; r ++ ){
+            xoshiro256 rng( stream_seed( seed, r ) );
+            int* column = indices + (size_t) r * sample_size;
+            draw_indices( rng, permutation, n, sample_size, replace, column );
+            for ( int i = 0; i < sample_size; i ++ ){
+                column[i] ++;
+            }
+        }
+    }
+
+    return( return_matrix );
+}
+
+// statistic: 0 = mean, 1 = quantile, 2 = Kolmogorov-Smirnov statistic against reference
+// [[Rcpp::export]]
+NumericVector CAB_cpp_resample_statistic( NumericVector x, int repeats, int sample_size, bool replace, int statistic, double probability, NumericVector reference ){
+
+    int n = x.length();
+    if ( n < 1 || repeats < 0 || sample_size < 1 ){
+        stop( "'x' must not be empty, 'repeats' must be non-negative and 'sample_size' must be positive." );
+    }
+    if ( !replace && sample_size > n ){
+        stop( "Cannot take a sample larger than the population when 'replace = FALSE'." );
+    }
+
+    if ( statistic == 1 && !( probability >= 0 && probability <= 1 ) ){
+        stop( "'probability' must be between 0 and 1." );
+    }
+    // NaN has no place in a sort order
+    for ( int i = 0; i < n; i ++ ){
+        if ( ISNAN( x[i] ) ) stop( "'x' must not have missing values." );
+    }
+    for ( int i = 0; i < reference.length(); i ++ ){
+        if ( ISNAN( reference[i] ) ) stop( "'reference' must not have missing values." );
+    }
+
+    const double* values = REAL( x );
+    std::vector<double> sorted_reference( reference.begin(), reference.end() );
+    std::sort( sorted_reference.begin(), sorted_reference.end() );
+    int n_reference = sorted_reference.size();
+    if ( statistic == 2 && n_reference < 1 ){
+        stop( "'reference' must not be empty for the KS statistic." );
+    }
+
+    NumericVector return_vector( repeats );
+    double* result = REAL( return_vector );
+    uint64_t seed = seed_from_uniforms( R::unif_rand(), R::unif_rand() );
+
+    #pragma omp parallel
+    {
+        std::vector<int> permutation;
+        std::vector<int> indices( sample_size );
+        std::vector<double> sample( sample_size );
+
+        #pragma omp for schedule(static)
+        for ( int r = 0; r < repeats; r ++ ){
+            xoshiro256 rng( stream_seed( seed, r ) );
+            draw_indices( rng, permutation, n, sample_size, replace, &indices[0] );
+
+            if ( statistic == 0 ){
+                double sum = 0;
+                for ( int i = 0; i < sample_size; i ++ ){
+                    sum += values[ indices[i] ];
+                }
+                result[r] = sum / sample_size;
+                continue;
+            }
+
+            for ( int i = 0; i < sample_size; i ++ ){
+                sample[i] = values[ indices[i] ];
+            }
+            if ( statistic == 1 ){
+                result[r] = quantile_7( &sample[0], sample_size, probability );
+            } else {
+                std::sort( sample.begin(), sample.end() );
+                result[r] = ks_sorted( &sample[0], sample_size, &sorted_reference[0], n_reference );
+            }
+        }
+    }
+
+    return( return_vector );
+}
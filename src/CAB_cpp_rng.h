@@ -0,0 +1,206 @@
+#ifndef CAB_CPP_RNG_H
+#define CAB_CPP_RNG_H
+
+#include <stdint.h>
+#include <cmath>
+#include <vector>
+
+// A small, fast random number generator (xoshiro256++) for use inside compiled kernels.
+// R's RNG cannot be called from threads, so kernels seed one of these from R's RNG on the main
+// thread (see seed_from_uniforms()) and derive an independent stream for each replicate or
+// organism with stream_seed(). Results then depend on set.seed() but not on the number of threads.
+
+inline uint64_t splitmix64( uint64_t& state ){
+    uint64_t z = ( state += 0x9E3779B97F4A7C15ULL );
+    z = ( z ^ ( z >> 30 ) ) * 0xBF58476D1CE4E5B9ULL;
+    z = ( z ^ ( z >> 27 ) ) * 0x94D049BB133111EBULL;
+    return( z ^ ( z >> 31 ) );
+}
+
+// A 64 bit seed from two U(0,1) draws, e.g. seed_from_uniforms( R::unif_rand(), R::unif_rand() )
+inline uint64_t seed_from_uniforms( double u1, double u2 ){
+    uint64_t high = (uint64_t) ( u1 * 4294967296.0 );
+    uint64_t low = (uint64_t) ( u2 * 4294967296.0 );
+    return( ( high << 32 ) | ( low & 0xFFFFFFFFULL ) );
+}
+
+// Seed of the stream'th independent stream from a base seed
+inline uint64_t stream_seed( uint64_t seed, uint64_t stream ){
+    uint64_t state = seed ^ ( stream * 0xD1B54A32D192ED03ULL );
+    return( splitmix64( state ) );
+}
+
+class xoshiro256 {
+public:
+    uint64_t s[4];
+
+    xoshiro256( uint64_t seed = 0 ){
+        set_seed( seed );
+    }
+
+    void set_seed( uint64_t seed ){
+        for ( int i = 0; i < 4; i ++ ){
+            s[i] = splitmix64( seed );
+        }
+    }
+
+    uint64_t next(){
+        uint64_t result = rotl( s[0] + s[3], 23 ) + s[0];
+        uint64_t t = s[1] << 17;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = rotl( s[3], 45 );
+        return( result );
+    }
+
+    // U[0,1)
+    double uniform(){
+        return( ( next() >> 11 ) * ( 1.0 / 9007199254740992.0 ) );
+    }
+
+    // Uniform integer on [0,n) without modulo bias (Lemire's method)
+    uint32_t bounded( uint32_t n ){
+        uint64_t m = (uint64_t) ( next() >> 32 ) * n;
+        uint32_t low = (uint32_t) m;
+        if ( low < n ){
+            uint32_t threshold = -n % n;
+            while ( low < threshold ){
+                m = (uint64_t) ( next() >> 32 ) * n;
+                low = (uint32_t) m;
+            }
+        }
+        return( (uint32_t) ( m >> 32 ) );
+    }
+
+    // Standard normal by the polar method
+    double normal(){
+        double u, v, r;
+        do {
+            u = 2 * uniform() - 1;
+            v = 2 * uniform() - 1;
+            r = u * u + v * v;
+        } while ( r >= 1 || r == 0 );
+        return( u * std::sqrt( -2 * std::log(r) / r ) );
+    }
+
+    // Exponential with rate 1
+    double exponential(){
+        return( -std::log1p( -uniform() ) );
+    }
+
+    // Number of failures before the first success, as in rgeom()
+    double geometric( double p ){
+        if ( p >= 1 ) return( 0 );
+        return( std::floor( std::log1p( -uniform() ) / std::log1p( -p ) ) );
+    }
+
+    // Failures before the size'th success, as in rnbinom(). O( size ).
+    double negative_binomial( int size, double p ){
+        double failures = 0;
+        for ( int i = 0; i < size; i ++ ) failures += geometric( p );
+        return( failures );
+    }
+
+    // Binomial( n, p ) by skipping between successes with geometric waiting times. O( n * p ).
+    int binomial( int n, double p ){
+        if ( p <= 0 || n <= 0 ) return( 0 );
+        if ( p >= 1 ) return( n );
+        int successes = 0;
+        double position = geometric( p );
+        while ( position < n ){
+            successes ++;
+            position += geometric( p ) + 1;
+        }
+        return( successes );
+    }
+
+private:
+    static uint64_t rotl( uint64_t x, int k ){
+        return( ( x << k ) | ( x >> ( 64 - k ) ) );
+    }
+};
+
+// Draws of one kind from a stream of their own, made a block at a time on demand. Memory does not
+// grow with the number of draws, and each refill is one tight loop over the generator.
+static const int RNG_BLOCK = 4096;
+
+template <typename T, typename Draw>
+class block_stream {
+public:
+    xoshiro256 rng;
+    Draw draw;
+
+    block_stream( uint64_t seed, const Draw& draw, int block_size = RNG_BLOCK ) :
+        rng( seed ), draw( draw ), block( block_size > 0 ? block_size : RNG_BLOCK ), at( block.size() ) {}
+
+    T next(){
+        if ( at == block.size() ) refill();
+        return( block[ at ++ ] );
+    }
+
+private:
+    std::vector<T> block;
+    size_t at;
+
+    void refill(){
+        for ( size_t i = 0; i < block.size(); i ++ ) block[i] = draw( rng );
+        at = 0;
+    }
+};
+
+// Uniform on [0,n)
+struct bounded_draw {
+    uint32_t n;
+    explicit bounded_draw( uint32_t n ) : n( n ) {}
+    uint32_t operator()( xoshiro256& rng ) const {
+        return( rng.bounded( n ) );
+    }
+};
+
+struct normal_draw {
+    double operator()( xoshiro256& rng ) const {
+        return( rng.normal() );
+    }
+};
+
+// Sampling without replacement of k of [0,n) into out[0..k-1] by partial Fisher-Yates.
+// permutation is scratch that holds the identity permutation of [0,n) between calls, so the sample only
+// depends on the RNG and not on earlier calls that shared the scratch. The k swaps are undone in O( k ):
+// every position past k that was swapped held a value that ended in the sample.
+inline void partial_fisher_yates( xoshiro256& rng, std::vector<int>& permutation, int n, int k, int* out ){
+    if ( (int) permutation.size() != n ){
+        permutation.resize( n );
+        for ( int i = 0; i < n; i ++ ) permutation[i] = i;
+    }
+    for ( int i = 0; i < k; i ++ ){
+        int j = i + rng.bounded( n - i );
+        int temp = permutation[i];
+        permutation[i] = permutation[j];
+        permutation[j] = temp;
+        out[i] = permutation[i];
+    }
+    for ( int i = 0; i < k; i ++ ) permutation[ out[i] ] = out[i];
+    for ( int i = 0; i < k; i ++ ) permutation[i] = i;
+}
+
+// Sampling without replacement of k of [0,n) by Floyd's algorithm. O( k^2 ) worst case, but needs no
+// O( n ) scratch, so it is for k much smaller than n. The sample is not in random order.
+inline void floyd_sample( xoshiro256& rng, int n, int k, int* out ){
+    int m = 0;
+    for ( int j = n - k; j < n; j ++ ){
+        int t = rng.bounded( j + 1 );
+        bool seen = false;
+        for ( int i = 0; i < m; i ++ ){
+            if ( out[i] == t ){
+                seen = true;
+                break;
+            }
+        }
+        out[ m ++ ] = seen ? j : t;
+    }
+}
+
+#endif
@@ -1,23 +1,32 @@
 // [[Rcpp::depends(RcppArmadillo)]]
 
 #include <RcppArmadillo.h>
+#include "CAB_cpp_profile.h"
+#include "CAB_cpp_arena.h"
 using namespace Rcpp;
 
 //'@export mcdowell_sampling
 //'@rdname CAB_samplers
 // [[Rcpp::export]]
 NumericMatrix mcdowell_sampling( NumericVector fitness, NumericVector fitness_weights ){
+
+    CAB_PROFILE_SCOPE( PROFILE_SELECTION );
     int size = fitness.length();
     NumericVector indices = wrap( seq( 0, size-1 ) );
 
     LogicalVector unique_fitness_indicator = !duplicated( fitness );
 
+    // fitness_weights2 goes to sample(), so it is an R vector. The other working copies are scratch.
     NumericVector fitness_weights2 = clone( fitness_weights );
-    NumericVector fitness2 = clone( fitness );
+    scratch_scope scope;
+    scratch_vector<double> fitness2;
+    fitness2.reserve( size );
+    for ( int i = 0; i < size; i ++ ) fitness2.push_back( fitness[i] );
 
     fitness_weights2[ !unique_fitness_indicator ] = 0;
     NumericVector selected_father_indices = sample( indices, size, true, fitness_weights2 );
-    LogicalVector matching_vector(size);
+    scratch_vector<int> matching;
+    matching.reserve( size );
     NumericVector selected_mother_indices(size);
     int duplicated_value = 0;
     NumericVector selected_mother(1);
@@ -26,20 +35,28 @@ NumericMatrix mcdowell_sampling( NumericVector fitness, NumericVector fitness_we
     for ( int i = 0; i < size; i ++ ){
         father_index = selected_father_indices(i);
 
-        fitness2( father_index ) = R_PosInf;
+        fitness2[ (int) father_index ] = R_PosInf;
         fitness_weights2( father_index ) = 0;
 
-        matching_vector = fitness( father_index ) == fitness2;
+        // Organisms other than the father with the father's fitness
+        matching.clear();
+        for ( int j = 0; j < size; j ++ ){
+            if ( fitness( father_index ) == fitness2[j] ) matching.push_back( j );
+        }
 
-        if ( is_true( any( matching_vector ) ) ){
-            fitness_weights2[ matching_vector ] = fitness_weights[ matching_vector ];
+        if ( !matching.empty() ){
+            for ( size_t j = 0; j < matching.size(); j ++ ){
+                fitness_weights2[ matching[j] ] = fitness_weights[ matching[j] ];
+            }
             duplicated_value = 1;
         }
         selected_mother_indices(i) = sample( indices, 1, true, fitness_weights2 )(0);
 
-        fitness2( father_index ) = fitness( father_index );
+        fitness2[ (int) father_index ] = fitness( father_index );
         fitness_weights2( father_index ) = fitness_weights[ father_index ];
-        fitness_weights2[ matching_vector ] = 0;
+        for ( size_t j = 0; j < matching.size(); j ++ ){
+            fitness_weights2[ matching[j] ] = 0;
+        }
         duplicated_value = 0;
 
     }
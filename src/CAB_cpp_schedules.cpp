@@ -0,0 +1,44 @@
+#include <Rcpp.h>
+#include "CAB_cpp_schedules_R.h"
+using namespace Rcpp;
+
+// [[Rcpp::export]]
+NumericVector CAB_cpp_schedule_batch( List schedule, int n ){
+    if ( n < 0 ) stop( "'n' must not be negative." );
+    schedule_set schedules = schedule_set_from_list( schedule );
+    if ( schedules.components.size() != 1 ){
+        stop( "Batches of intervals are for simple schedules." );
+    }
+    NumericVector intervals( n );
+    xoshiro256 rng( seed_from_uniforms( R::unif_rand(), R::unif_rand() ) );
+    schedule_batch( schedules.components[0].spec, rng, n, REAL(intervals) );
+    return( intervals );
+}
+
+// Outcome of each response: 0 = nothing, 1 = a link of a chained schedule is completed, 2 = reinforcer.
+// alternatives count from 0 and pick the component of a concurrent schedule.
+// [[Rcpp::export]]
+List CAB_cpp_run_schedule( List schedule, NumericVector times, IntegerVector alternatives, double start ){
+
+    int n = times.length();
+    if ( alternatives.length() != n && alternatives.length() != 1 ){
+        stop( "'alternatives' must have one element or one for each response." );
+    }
+
+    schedule_set schedules = schedule_set_from_list( schedule );
+    xoshiro256 rng( seed_from_uniforms( R::unif_rand(), R::unif_rand() ) );
+    schedules.start( rng, start );
+
+    IntegerVector outcomes( n );
+    IntegerVector link( n );
+    bool one_alternative = alternatives.length() == 1;
+    for ( int i = 0; i < n; i ++ ){
+        if ( i > 0 && times[i] < times[i-1] ){
+            stop( "Response times must be sorted." );
+        }
+        link[i] = schedules.link;
+        outcomes[i] = schedules.response( rng, one_alternative ? alternatives[0] : alternatives[i], times[i] );
+    }
+
+    return( List::create( Named("outcome") = outcomes, Named("link") = link, Named("next_event_time") = schedules.next_event_time() ) );
+}
@@ -0,0 +1,218 @@
+#ifndef CAB_CPP_SCHEDULES_H
+#define CAB_CPP_SCHEDULES_H
+
+#include <vector>
+#include <cmath>
+#include <limits>
+#include "CAB_cpp_rng.h"
+
+// Reinforcement schedules for the compiled engines.
+// Times are in whatever unit the engine uses (ticks for EBD, real time for COR). Interval schedules
+// arrange the time at which the next response is reinforced, which is exposed by next_event_time() so
+// that an engine can skip the idle time before it instead of checking every tick.
+
+enum schedule_type {
+    SCHEDULE_VI_GEOMETRIC,
+    SCHEDULE_VI_EXPONENTIAL,
+    SCHEDULE_VI_FLESHLER_HOFFMAN,
+    SCHEDULE_VR,
+    SCHEDULE_FI,
+    SCHEDULE_FR,
+    SCHEDULE_EXTINCTION
+};
+
+enum schedule_mode { SCHEDULE_SIMPLE, SCHEDULE_CONCURRENT, SCHEDULE_CHAINED };
+
+enum schedule_outcome { OUTCOME_NONE, OUTCOME_LINK, OUTCOME_REINFORCER };
+
+struct schedule_spec {
+    int type;
+    double value;       // mean interval, mean ratio, or the fixed interval or ratio
+    double shift;       // added to every interval, divided by min_irt for SCHEDULE_VI_GEOMETRIC
+    double min_irt;     // SCHEDULE_VI_GEOMETRIC only, as in EBD.shifted_geometric_vi
+    int n_intervals;    // SCHEDULE_VI_FLESHLER_HOFFMAN only
+};
+
+// Fleshler & Hoffman (1962) progression of n intervals with the given mean
+inline void fleshler_hoffman( double mean, int n, std::vector<double>& intervals ){
+    intervals.resize( n );
+    for ( int i = 1; i <= n; i ++ ){
+        double a = n - i;
+        double b = n - i + 1;
+        double a_log_a = a > 0 ? a * std::log(a) : 0;
+        intervals[ i - 1 ] = mean * ( 1 + std::log( (double) n ) + a_log_a - b * std::log(b) );
+    }
+}
+
+class schedule {
+public:
+    schedule_spec spec;
+    double armed_time;              // interval schedules: the first time at which a response is reinforced
+    int remaining;                  // ratio schedules: responses left until reinforcement
+    std::vector<double> progression;    // Fleshler-Hoffman intervals, used in a random order
+    int cursor;
+
+    schedule() : armed_time( std::numeric_limits<double>::infinity() ), remaining( 0 ), cursor( 0 ) {
+        spec.type = SCHEDULE_EXTINCTION;
+        spec.value = 0;
+        spec.shift = 0;
+        spec.min_irt = 1;
+        spec.n_intervals = 0;
+    }
+
+    explicit schedule( const schedule_spec& spec ) : spec( spec ), armed_time( std::numeric_limits<double>::infinity() ), remaining( 0 ), cursor( 0 ) {
+        if ( spec.type == SCHEDULE_VI_FLESHLER_HOFFMAN ){
+            fleshler_hoffman( spec.value, spec.n_intervals, progression );
+            cursor = spec.n_intervals;
+        }
+    }
+
+    bool is_interval() const {
+        return( spec.type == SCHEDULE_VI_GEOMETRIC || spec.type == SCHEDULE_VI_EXPONENTIAL ||
+            spec.type == SCHEDULE_VI_FLESHLER_HOFFMAN || spec.type == SCHEDULE_FI );
+    }
+
+    bool is_ratio() const {
+        return( spec.type == SCHEDULE_VR || spec.type == SCHEDULE_FR );
+    }
+
+    double draw_interval( xoshiro256& rng ){
+        switch( spec.type ){
+            case SCHEDULE_VI_GEOMETRIC:
+                // As EBD.shifted_geometric_vi, where the shift is in real time and is scaled with the intervals
+                return( rng.geometric( 1 - std::exp( -1 / spec.value ) ) / spec.min_irt + 1 + spec.shift / spec.min_irt );
+            case SCHEDULE_VI_EXPONENTIAL:
+                return( rng.exponential() * spec.value + spec.shift );
+            case SCHEDULE_VI_FLESHLER_HOFFMAN:
+                // Sample the progression without replacement, reshuffling when it runs out
+                if ( cursor >= spec.n_intervals ) cursor = 0;
+                {
+                    int j = cursor + rng.bounded( spec.n_intervals - cursor );
+                    double temp = progression[cursor];
+                    progression[cursor] = progression[j];
+                    progression[j] = temp;
+                }
+                return( progression[ cursor ++ ] + spec.shift );
+            case SCHEDULE_FI:
+                return( spec.value + spec.shift );
+            default:
+                return( std::numeric_limits<double>::infinity() );
+        }
+    }
+
+    // Random ratio for VR, so every response is reinforced with probability 1 / value
+    int draw_ratio( xoshiro256& rng ){
+        if ( spec.type == SCHEDULE_VR ) return( (int) rng.geometric( 1 / spec.value ) + 1 );
+        return( (int) spec.value );
+    }
+
+    // Arrange the next reinforcer from time
+    void start( xoshiro256& rng, double time ){
+        if ( is_interval() ){
+            armed_time = time + draw_interval( rng );
+        } else if ( is_ratio() ){
+            remaining = draw_ratio( rng );
+        }
+    }
+
+    // The time from which the next response is reinforced, or Inf if that depends on responses only
+    double next_event_time() const {
+        return( is_interval() ? armed_time : std::numeric_limits<double>::infinity() );
+    }
+
+    // Responses still needed, 1 for an armed interval schedule and 0 when no count applies
+    int responses_to_reinforcer( double time ) const {
+        if ( is_ratio() ) return( remaining );
+        if ( is_interval() && time >= armed_time ) return( 1 );
+        return( 0 );
+    }
+
+    bool response( xoshiro256& rng, double time ){
+        if ( is_interval() ){
+            if ( time < armed_time ) return( false );
+            start( rng, time );
+            return( true );
+        }
+        if ( is_ratio() ){
+            if ( -- remaining > 0 ) return( false );
+            start( rng, time );
+            return( true );
+        }
+        return( false );
+    }
+};
+
+// A simple schedule, independent concurrent schedules with one per alternative, or a chain of links
+// where completing a link starts the next and completing the last delivers the reinforcer.
+class schedule_set {
+public:
+    int mode;
+    std::vector<schedule> components;
+    int link;
+
+    schedule_set() : mode( SCHEDULE_SIMPLE ), link( 0 ) {}
+
+    void start( xoshiro256& rng, double time ){
+        link = 0;
+        if ( mode == SCHEDULE_CONCURRENT ){
+            for ( size_t i = 0; i < components.size(); i ++ ) components[i].start( rng, time );
+        } else if ( !components.empty() ){
+            components[0].start( rng, time );
+        }
+    }
+
+    double next_event_time() const {
+        double next = std::numeric_limits<double>::infinity();
+        if ( components.empty() ) return( next );
+        if ( mode == SCHEDULE_CONCURRENT ){
+            for ( size_t i = 0; i < components.size(); i ++ ){
+                next = std::min( next, components[i].next_event_time() );
+            }
+            return( next );
+        }
+        return( components[ mode == SCHEDULE_CHAINED ? link : 0 ].next_event_time() );
+    }
+
+    // Whether the schedule counts responses, so that every response must be passed to it
+    bool counts_responses() const {
+        if ( components.empty() ) return( false );
+        if ( mode == SCHEDULE_CONCURRENT ){
+            for ( size_t i = 0; i < components.size(); i ++ ){
+                if ( components[i].is_ratio() ) return( true );
+            }
+            return( false );
+        }
+        return( components[ mode == SCHEDULE_CHAINED ? link : 0 ].is_ratio() );
+    }
+
+    // alternative counts from 0. It picks the component of a concurrent schedule and is ignored otherwise.
+    int response( xoshiro256& rng, int alternative, double time ){
+        if ( components.empty() ) return( OUTCOME_NONE );
+        if ( mode == SCHEDULE_CONCURRENT ){
+            if ( alternative < 0 || alternative >= (int) components.size() ) return( OUTCOME_NONE );
+            return( components[ alternative ].response( rng, time ) ? OUTCOME_REINFORCER : OUTCOME_NONE );
+        }
+        if ( mode == SCHEDULE_SIMPLE ){
+            return( components[0].response( rng, time ) ? OUTCOME_REINFORCER : OUTCOME_NONE );
+        }
+        if ( !components[ link ].response( rng, time ) ) return( OUTCOME_NONE );
+        if ( link + 1 < (int) components.size() ){
+            link ++;
+            components[ link ].start( rng, time );
+            return( OUTCOME_LINK );
+        }
+        link = 0;
+        components[0].start( rng, time );
+        return( OUTCOME_REINFORCER );
+    }
+};
+
+// n intervals (interval schedules) or ratio requirements (ratio schedules) in one batch
+inline void schedule_batch( const schedule_spec& spec, xoshiro256& rng, int n, double* out ){
+    schedule s( spec );
+    for ( int i = 0; i < n; i ++ ){
+        out[i] = s.is_ratio() ? s.draw_ratio( rng ) : s.draw_interval( rng );
+    }
+}
+
+#endif
@@ -0,0 +1,46 @@
+#ifndef CAB_CPP_SCHEDULES_R_H
+#define CAB_CPP_SCHEDULES_R_H
+
+#include <Rcpp.h>
+#include "CAB_cpp_schedules.h"
+
+// Schedules from the lists made by make.schedule(), make.concurrent_schedule() and make.chained_schedule().
+// Call on the main thread, before any threads start.
+
+inline schedule_spec schedule_spec_from_list( Rcpp::List component ){
+    schedule_spec spec;
+    spec.type = Rcpp::as<int>( component["type_code"] );
+    spec.value = Rcpp::as<double>( component["value"] );
+    spec.shift = Rcpp::as<double>( component["shift"] );
+    spec.min_irt = Rcpp::as<double>( component["min_irt"] );
+    spec.n_intervals = Rcpp::as<int>( component["n_intervals"] );
+
+    if ( spec.type < SCHEDULE_VI_GEOMETRIC || spec.type > SCHEDULE_EXTINCTION ){
+        Rcpp::stop( "Unknown schedule type." );
+    }
+    if ( spec.type != SCHEDULE_EXTINCTION && !( spec.value > 0 ) ){
+        Rcpp::stop( "Schedule values must be positive." );
+    }
+    if ( spec.type == SCHEDULE_VI_FLESHLER_HOFFMAN && spec.n_intervals < 1 ){
+        Rcpp::stop( "A Fleshler-Hoffman schedule needs at least one interval." );
+    }
+    if ( spec.type == SCHEDULE_VR && spec.value < 1 ){
+        Rcpp::stop( "The mean of a VR schedule must be at least 1." );
+    }
+    return( spec );
+}
+
+inline schedule_set schedule_set_from_list( Rcpp::List spec ){
+    schedule_set schedules;
+    schedules.mode = Rcpp::as<int>( spec["mode_code"] );
+    Rcpp::List components = spec["components"];
+    for ( int i = 0; i < components.length(); i ++ ){
+        schedules.components.push_back( schedule( schedule_spec_from_list( components[i] ) ) );
+    }
+    if ( schedules.components.empty() ){
+        Rcpp::stop( "A schedule needs at least one component." );
+    }
+    return( schedules );
+}
+
+#endif
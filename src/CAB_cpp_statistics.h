@@ -0,0 +1,51 @@
+#ifndef CAB_CPP_STATISTICS_H
+#define CAB_CPP_STATISTICS_H
+
+#include <cmath>
+#include <algorithm>
+#include <limits>
+
+// Small statistics shared by the compiled kernels.
+
+// Two sample Kolmogorov-Smirnov statistic between two sorted samples. Tied values are stepped over together, as in ks().
+// NaN equals nothing, so the walk stops at the first NaN; callers should leave them out.
+inline double ks_sorted( const double* sample_1, int n1, const double* sample_2, int n2 ){
+    int i = 0;
+    int j = 0;
+    double d = 0;
+    while ( i < n1 && j < n2 ){
+        if ( sample_1[i] != sample_1[i] || sample_2[j] != sample_2[j] ) break;
+        double value = std::min( sample_1[i], sample_2[j] );
+        while ( i < n1 && sample_1[i] == value ) i ++;
+        while ( j < n2 && sample_2[j] == value ) j ++;
+        d = std::max( d, std::fabs( (double) i / n1 - (double) j / n2 ) );
+    }
+    return( d );
+}
+
+// Running mean and variance by Welford's method
+struct running_statistics {
+    int n;
+    double mean;
+    double m2;
+
+    running_statistics() : n( 0 ), mean( 0 ), m2( 0 ) {}
+
+    void add( double x ){
+        n ++;
+        double delta = x - mean;
+        mean += delta / n;
+        m2 += delta * ( x - mean );
+    }
+
+    double variance() const {
+        return( n > 1 ? m2 / ( n - 1 ) : 0 );
+    }
+
+    // Half width of a normal confidence interval for the mean with quantile z
+    double half_width( double z ) const {
+        return( n > 1 ? z * std::sqrt( variance() / n ) : std::numeric_limits<double>::infinity() );
+    }
+};
+
+#endif
@@ -0,0 +1,94 @@
+#include <Rcpp.h>
+#include "CAB_cpp_event_record.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+using namespace Rcpp;
+
+// Codes of the events of a record for transition_counts.
+// The counted labels are coded from 0, break events that are not counted follow them, and other events are -1.
+static std::vector<int> transition_codes( CharacterVector events, CharacterVector codes_of ){
+    // match() indexes from 1, subtract 1
+    IntegerVector matched = match( events, codes_of );
+    std::vector<int> codes( matched.length() );
+    for ( int i = 0; i < matched.length(); i ++ ){
+        codes[i] = matched[i] == NA_INTEGER ? -1 : matched[i] - 1;
+    }
+    return( codes );
+}
+
+// The labels followed by the break events that are not labels, and whether each of them is a break
+static CharacterVector transition_coding( CharacterVector labels, CharacterVector break_events, std::vector<int>& breaks ){
+    CharacterVector extra_breaks = setdiff( break_events, labels );
+    int n_labels = labels.length();
+    CharacterVector codes_of( n_labels + extra_breaks.length() );
+    breaks.assign( codes_of.length(), 1 );
+
+    LogicalVector label_breaks = in( labels, break_events );
+    for ( int l = 0; l < n_labels; l ++ ){
+        codes_of[l] = labels[l];
+        breaks[l] = label_breaks[l];
+    }
+    for ( int b = 0; b < extra_breaks.length(); b ++ ){
+        codes_of[ n_labels + b ] = extra_breaks[b];
+    }
+    return( codes_of );
+}
+
+static IntegerVector transition_array( const std::vector<int>& counts, CharacterVector labels, int max_lag ){
+    IntegerVector transitions( counts.begin(), counts.end() );
+    transitions.attr( "dim" ) = IntegerVector::create( labels.length(), labels.length(), max_lag );
+    transitions.attr( "dimnames" ) = List::create( Named("from") = labels, Named("to") = labels, Named("lag") = seq( 1, max_lag ) );
+    return( transitions );
+}
+
+static void check_lag( int max_lag ){
+    if ( max_lag < 1 || max_lag == NA_INTEGER ) stop( "'lag' must be at least 1" );
+}
+
+// [[Rcpp::export]]
+IntegerVector CAB_cpp_transitions_formal_event_record( DataFrame data, CharacterVector labels, CharacterVector break_events, int max_lag ){
+
+    check_lag( max_lag );
+
+    std::vector<int> breaks;
+    CharacterVector codes_of = transition_coding( labels, break_events, breaks );
+    std::vector<int> codes = transition_codes( data["event"], codes_of );
+
+    int n_labels = labels.length();
+    std::vector<int> counts( n_labels * n_labels * max_lag, 0 );
+    transition_counts( codes.data(), (int) codes.size(), breaks.data(), n_labels, max_lag, counts.data() );
+
+    return( transition_array( counts, labels, max_lag ) );
+}
+
+// [[Rcpp::export]]
+List CAB_cpp_transitions_sessions( List sessions, CharacterVector labels, CharacterVector break_events, int max_lag ){
+
+    check_lag( max_lag );
+
+    int n_sessions = sessions.length();
+    int n_labels = labels.length();
+    std::vector<int> breaks;
+    CharacterVector codes_of = transition_coding( labels, break_events, breaks );
+
+    // Everything that touches R happens here, before the threads start
+    std::vector< std::vector<int> > codes( n_sessions );
+    std::vector< std::vector<int> > counts( n_sessions );
+    for ( int s = 0; s < n_sessions; s ++ ){
+        DataFrame data = as<DataFrame>( sessions[s] );
+        codes[s] = transition_codes( data["event"], codes_of );
+        counts[s].assign( n_labels * n_labels * max_lag, 0 );
+    }
+
+    #pragma omp parallel for schedule(dynamic)
+    for ( int s = 0; s < n_sessions; s ++ ){
+        transition_counts( codes[s].data(), (int) codes[s].size(), breaks.data(), n_labels, max_lag, counts[s].data() );
+    }
+
+    List return_list( n_sessions );
+    for ( int s = 0; s < n_sessions; s ++ ){
+        return_list[s] = transition_array( counts[s], labels, max_lag );
+    }
+    return( return_list );
+}
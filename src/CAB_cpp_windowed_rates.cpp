@@ -0,0 +1,181 @@
+#include <Rcpp.h>
+#include "CAB_cpp_event_record.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+using namespace Rcpp;
+
+// Fills a n_windows x n_labels column-major matrix of rates for one session.
+// times are the record times, codes the label of each row (-1 for unrequested labels).
+// start, window and step are in the units of times, which are time_scale units of time long, and the rates
+// are per unit of time.
+template< typename Time >
+static void windowed_rates_helper( const Time* times, const int* codes, int n_rows, int n_labels, double start, double window, double step, int n_windows, double time_scale, double* rates ){
+
+    label_index index;
+    build_label_index( codes, n_rows, n_labels, index );
+
+    std::vector<Time> label_times( 0 );
+    std::vector<int> counts( n_windows );
+
+    for ( int l = 0; l < n_labels; l ++ ){
+        int first = index.offsets[l];
+        int n_times = index.offsets[l+1] - first;
+
+        label_times.resize( n_times );
+        for ( int i = 0; i < n_times; i ++ ){
+            label_times[i] = times[ index.rows[ first + i ] ];
+        }
+
+        window_counts( label_times.data(), n_times, start, window, step, n_windows, counts.data() );
+
+        for ( int w = 0; w < n_windows; w ++ ){
+            rates[ l * n_windows + w ] = counts[w] / ( window * time_scale );
+        }
+    }
+}
+
+static NumericVector window_starts( double start, double step, int n_windows ){
+    NumericVector starts( n_windows );
+    for ( int w = 0; w < n_windows; w ++ ){
+        starts[w] = start + w * step;
+    }
+    return( starts );
+}
+
+static void check_window( double window, double step ){
+    if ( !( window > 0 ) || !( step > 0 ) ){
+        stop( "'window' and 'step' must be positive" );
+    }
+}
+
+static void check_span( double start, double end ){
+    if ( !R_finite( start ) || !R_finite( end ) ){
+        stop( "The start and end of a session must be finite" );
+    }
+}
+
+// The times are doubles, or integer ticks that are time_scale units of time long. window, step, start and end
+// are in units of time.
+// [[Rcpp::export]]
+List CAB_cpp_windowed_rates_formal_event_record( DataFrame data, CharacterVector labels, double window, double step, double start, double end, double time_scale = 1 ){
+
+    check_window( window, step );
+
+    SEXP time = data["time"];
+    CharacterVector events = data["event"];
+
+    // match() indexes from 1, subtract 1
+    IntegerVector codes = match( events, labels ) - 1;
+    int n_rows = events.length();
+    for ( int i = 0; i < n_rows; i ++ ){
+        if ( codes[i] < 0 ) codes[i] = -1;
+    }
+
+    int n_labels = labels.length();
+    check_span( start, end );
+    int n_windows = count_windows( start, end, window, step );
+    NumericMatrix rates( n_windows, n_labels );
+
+    // Integer ticks are counted as they are, with the windows converted to ticks
+    if ( TYPEOF( time ) == INTSXP ){
+        windowed_rates_helper( INTEGER( time ), codes.begin(), n_rows, n_labels, start / time_scale, window / time_scale, step / time_scale, n_windows, time_scale, rates.begin() );
+    }
+    else{
+        NumericVector times( time );
+        windowed_rates_helper( times.begin(), codes.begin(), n_rows, n_labels, start / time_scale, window / time_scale, step / time_scale, n_windows, time_scale, rates.begin() );
+    }
+    colnames( rates ) = labels;
+
+    List return_list = List::create( Named("window_start") = window_starts( start, step, n_windows ), Named("rates") = rates );
+    return( return_list );
+}
+
+// [[Rcpp::export]]
+List CAB_cpp_windowed_rates_ragged_event_record( List event_times, IntegerVector counts, double window, double step, double start, double end ){
+
+    check_window( window, step );
+
+    int n_labels = event_times.length();
+    check_span( start, end );
+    int n_windows = count_windows( start, end, window, step );
+    NumericMatrix rates( n_windows, n_labels );
+    std::vector<int> window_count( n_windows );
+
+    for ( int l = 0; l < n_labels; l ++ ){
+        NumericVector times = event_times[l];
+        // Ragged records are preallocated, so only the first counts[l] times are events
+        int n_times = std::min( (int) times.length(), counts[l] );
+
+        window_counts( times.begin(), n_times, start, window, step, n_windows, window_count.data() );
+
+        for ( int w = 0; w < n_windows; w ++ ){
+            rates( w, l ) = window_count[w] / window;
+        }
+    }
+    CharacterVector labels = event_times.names();
+    colnames( rates ) = labels;
+
+    List return_list = List::create( Named("window_start") = window_starts( start, step, n_windows ), Named("rates") = rates );
+    return( return_list );
+}
+
+// [[Rcpp::export]]
+List CAB_cpp_windowed_rates_sessions( List sessions, CharacterVector labels, double window, double step, NumericVector start, NumericVector end, double time_scale = 1 ){
+
+    check_window( window, step );
+
+    int n_sessions = sessions.length();
+    int n_labels = labels.length();
+
+    // Everything that touches R happens here, before the threads start
+    std::vector<NumericVector> times( n_sessions );
+    std::vector<const double*> time_pointers( n_sessions, (const double*) NULL );
+    std::vector<const int*> tick_pointers( n_sessions, (const int*) NULL );
+    std::vector< std::vector<int> > codes( n_sessions );
+    std::vector<int> n_windows( n_sessions );
+    std::vector< std::vector<double> > rates( n_sessions );
+    std::vector<double> session_start( start.begin(), start.end() );
+
+    for ( int s = 0; s < n_sessions; s ++ ){
+        DataFrame data = as<DataFrame>( sessions[s] );
+        SEXP time = data["time"];
+        if ( TYPEOF( time ) == INTSXP ){
+            tick_pointers[s] = INTEGER( time );
+        }
+        else{
+            times[s] = time;
+            time_pointers[s] = times[s].begin();
+        }
+        CharacterVector events = data["event"];
+        IntegerVector matched = match( events, labels );
+
+        codes[s].resize( matched.length() );
+        for ( int i = 0; i < matched.length(); i ++ ){
+            codes[s][i] = matched[i] == NA_INTEGER ? -1 : matched[i] - 1;
+        }
+
+        check_span( start[s], end[s] );
+        n_windows[s] = count_windows( start[s], end[s], window, step );
+        rates[s].resize( n_windows[s] * n_labels );
+    }
+
+    #pragma omp parallel for schedule(dynamic)
+    for ( int s = 0; s < n_sessions; s ++ ){
+        if ( tick_pointers[s] ){
+            windowed_rates_helper( tick_pointers[s], codes[s].data(), (int) codes[s].size(), n_labels, session_start[s] / time_scale, window / time_scale, step / time_scale, n_windows[s], time_scale, rates[s].data() );
+        }
+        else{
+            windowed_rates_helper( time_pointers[s], codes[s].data(), (int) codes[s].size(), n_labels, session_start[s] / time_scale, window / time_scale, step / time_scale, n_windows[s], time_scale, rates[s].data() );
+        }
+    }
+
+    List return_list( n_sessions );
+    for ( int s = 0; s < n_sessions; s ++ ){
+        NumericMatrix session_rates( n_windows[s], n_labels, rates[s].begin() );
+        colnames( session_rates ) = labels;
+        return_list[s] = List::create( Named("window_start") = window_starts( start[s], step, n_windows[s] ), Named("rates") = session_rates );
+    }
+
+    return( return_list );
+}
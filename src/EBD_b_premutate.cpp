@@ -1,6 +1,7 @@
 // [[Rcpp::depends(RcppArmadillo)]]
 
 #include <RcppArmadillo.h>
+#include "CAB_cpp_profile.h"
 using namespace Rcpp ;
 
 // This is a simple example of exporting a C++ function to R. You can
@@ -18,6 +19,8 @@ using namespace Rcpp ;
 // [[Rcpp::export]]
 List EBD_B_premutate( double mutation_rate, int pop_size, int total_ticks, int n_bits ){
 
+    CAB_PROFILE_SCOPE( PROFILE_MUTATION );
+
     List mutant_indices = List( total_ticks+1 );
 
     NumericVector binom_vect = rbinom( total_ticks+1, pop_size, mutation_rate );
@@ -0,0 +1,53 @@
+#include <Rcpp.h>
+#include <climits>
+#include "EBD_batch.h"
+#include "EBD_engine_R.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+using namespace Rcpp;
+
+// phenotypes has the starting population of each organism in a column. Events are coded as in ebd_record.
+// [[Rcpp::export]]
+List CAB_cpp_EBD_batch( List parameters, List schedule, IntegerMatrix phenotypes, double ticks, int max_reinforcers ){
+
+    ebd_parameters p = ebd_parameters_from_list( parameters );
+    schedule_set schedules = schedule_set_from_list( schedule );
+
+    int pop_size = phenotypes.nrow();
+    int n_organisms = phenotypes.ncol();
+    if ( n_organisms < 1 ) stop( "There must be at least one organism." );
+    if ( pop_size < 2 ) stop( "The population needs at least two organisms." );
+    if ( !( ticks >= 0 ) ) stop( "'ticks' must not be negative." );
+    int max_phenotype = ( 1 << p.n_bits ) - 1;
+    for ( int i = 0; i < phenotypes.length(); i ++ ){
+        if ( phenotypes[i] < 0 || phenotypes[i] > max_phenotype ){
+            stop( "Phenotype at position %d is outside [0, 2^n_bits - 1].", i + 1 );
+        }
+    }
+
+    ebd_batch batch( p, schedules, seed_from_uniforms( R::unif_rand(), R::unif_rand() ),
+        std::vector<int>( phenotypes.begin(), phenotypes.end() ), n_organisms );
+
+    int n_lanes = ( n_organisms + EBD_BATCH_LANE - 1 ) / EBD_BATCH_LANE;
+    #pragma omp parallel for schedule(dynamic)
+    for ( int lane = 0; lane < n_lanes; lane ++ ){
+        int first = lane * EBD_BATCH_LANE;
+        batch.run( first, std::min( n_organisms, first + EBD_BATCH_LANE ), (long long) ticks, max_reinforcers );
+    }
+
+    List sessions( n_organisms );
+    NumericVector organism_ticks( n_organisms );
+    for ( int o = 0; o < n_organisms; o ++ ){
+        sessions[o] = List::create( Named("time") = batch.records[o].time, Named("event") = batch.records[o].event );
+        organism_ticks[o] = (double) batch.ticks[o];
+    }
+    IntegerMatrix final_phenotypes( pop_size, n_organisms );
+    std::copy( batch.phenotypes.begin(), batch.phenotypes.end(), final_phenotypes.begin() );
+
+    return( List::create(
+        Named("sessions") = sessions,
+        Named("phenotypes") = final_phenotypes,
+        Named("ticks") = organism_ticks,
+        Named("reinforcers") = batch.reinforcers ) );
+}
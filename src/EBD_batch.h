@@ -0,0 +1,212 @@
+#ifndef EBD_BATCH_H
+#define EBD_BATCH_H
+
+#include <vector>
+#include <cmath>
+#include <limits>
+#include "EBD_engine.h"
+#include "CAB_cpp_arena.h"
+
+// Many EBD organisms advanced tick by tick in lockstep.
+// Each organism is a population with its own RNG stream, schedule and record, run as ebd_engine runs the
+// stock pipeline. The state of the organisms is kept as a structure of arrays indexed by organism, so the
+// work that every organism does every tick (drawing the emitter, classifying the emitted phenotype and
+// checking whether it could change the schedule) is a loop over contiguous memory that the compiler can
+// vectorise. Only the organisms that need it go on to the schedule, reproduction and mutation.
+// Organisms are advanced in lanes of consecutive organisms, which can run in different threads.
+//
+// An organism takes the same draws as ebd_engine in skipping mode when that has no idle runs (ratio
+// schedules) and otherwise has the same distribution of sessions.
+
+// Organisms in a lane
+static const int EBD_BATCH_LANE = 64;
+
+class ebd_batch {
+public:
+    ebd_parameters parameters;
+    int n_organisms;
+    int pop_size;
+
+    // The population of organism o is phenotypes[ o * pop_size ] to phenotypes[ ( o + 1 ) * pop_size - 1 ]
+    std::vector<int> phenotypes;
+    // xoshiro256 state of each organism
+    std::vector<uint64_t> s0, s1, s2, s3;
+    std::vector<long long> next_mutation;   // slots as in ebd_engine, counted for each organism
+    std::vector<double> check_from;         // responses before this time cannot change the schedule
+    std::vector<int> reinforcers;
+    std::vector<long long> ticks;           // ticks run by each organism
+    std::vector<schedule_set> schedules;
+    std::vector<ebd_record> records;
+
+    // Organism o uses the stream stream_seed( seed, o ), as ebd_engine does with that seed
+    ebd_batch( const ebd_parameters& parameters, const schedule_set& schedule, uint64_t seed, const std::vector<int>& phenotypes, int n_organisms ) :
+        parameters( parameters ), n_organisms( n_organisms ), pop_size( phenotypes.size() / n_organisms ), phenotypes( phenotypes ),
+        s0( n_organisms ), s1( n_organisms ), s2( n_organisms ), s3( n_organisms ),
+        next_mutation( n_organisms ), check_from( n_organisms ), reinforcers( n_organisms, 0 ), ticks( n_organisms, 0 ),
+        schedules( n_organisms, schedule ), records( n_organisms ) {
+
+        for ( int o = 0; o < n_organisms; o ++ ){
+            xoshiro256 rng( stream_seed( seed, o ) );
+            schedules[o].start( rng, 0 );
+            update_check_from( o );
+            if ( parameters.mutation_rate <= 0 ){
+                next_mutation[o] = std::numeric_limits<long long>::max();
+            } else {
+                advance_mutation( rng, o, 0 );
+            }
+            store_rng( o, rng );
+        }
+    }
+
+    // Advance organisms [first, last) until end_tick, or until an organism has max_reinforcers reinforcers
+    void run( int first, int last, long long end_tick, int max_reinforcers ){
+        scratch_scope scope;
+        int n = last - first;
+        scratch_vector<int> emitter( n ), alternative( n ), active( n );
+        scratch_vector<int> fitness( pop_size ), fathers( pop_size ), mothers( pop_size ), children( pop_size );
+        fitness_histogram histogram;
+
+        uint32_t threshold = -(uint32_t) pop_size % (uint32_t) pop_size;
+        int n_alternatives = parameters.class_lower.size();
+        const int* class_lower = &parameters.class_lower[0];
+        const int* class_upper = &parameters.class_upper[0];
+        uint64_t* a = &s0[first];
+        uint64_t* b = &s1[first];
+        uint64_t* c = &s2[first];
+        uint64_t* d = &s3[first];
+
+        for ( long long tick = 0; tick < end_tick; tick ++ ){
+
+            int n_active = 0;
+            for ( int i = 0; i < n; i ++ ){
+                active[i] = reinforcers[ first + i ] < max_reinforcers;
+                n_active += active[i];
+            }
+            if ( n_active == 0 ) break;
+
+            // Emitters of every organism, by xoshiro256++ and Lemire's method as in xoshiro256::bounded()
+            for ( int i = 0; i < n; i ++ ){
+                uint64_t x = a[i] + d[i];
+                uint64_t result = ( ( x << 23 ) | ( x >> 41 ) ) + a[i];
+                uint64_t t = b[i] << 17;
+                c[i] ^= a[i];
+                d[i] ^= b[i];
+                b[i] ^= c[i];
+                a[i] ^= d[i];
+                c[i] ^= t;
+                d[i] = ( d[i] << 45 ) | ( d[i] >> 19 );
+                uint64_t m = ( result >> 32 ) * (uint64_t) pop_size;
+                emitter[i] = (uint32_t) m < threshold ? -1 : (int) ( m >> 32 );
+            }
+            // Rejected draws are redrawn one organism at a time
+            for ( int i = 0; i < n; i ++ ){
+                if ( emitter[i] < 0 ){
+                    xoshiro256 rng = load_rng( first + i );
+                    emitter[i] = rng.bounded( pop_size );
+                    store_rng( first + i, rng );
+                }
+            }
+
+            // The alternative of each emitted phenotype, or -1
+            for ( int i = 0; i < n; i ++ ){
+                int phenotype = phenotypes[ (size_t) ( first + i ) * pop_size + emitter[i] ];
+                int found = -1;
+                for ( int k = n_alternatives - 1; k >= 0; k -- ){
+                    found = phenotype >= class_lower[k] && phenotype <= class_upper[k] ? k : found;
+                }
+                alternative[i] = active[i] ? found : -1;
+            }
+
+            for ( int i = 0; i < n; i ++ ){
+                if ( alternative[i] < 0 ) continue;
+                int o = first + i;
+                records[o].push( (double) tick, alternative[i] );
+                if ( !operates_schedule( o, alternative[i] ) || (double) tick < check_from[o] ) continue;
+
+                xoshiro256 rng = load_rng( o );
+                int outcome = schedules[o].response( rng, alternative[i], (double) tick );
+                if ( outcome == OUTCOME_LINK ){
+                    records[o].push( (double) tick, 2 * n_alternatives );
+                } else if ( outcome == OUTCOME_REINFORCER ){
+                    records[o].push( (double) tick, n_alternatives + alternative[i] );
+                    reinforcers[o] ++;
+                    reproduce( rng, o, phenotypes[ (size_t) o * pop_size + emitter[i] ], histogram,
+                        &fitness[0], &fathers[0], &mothers[0], &children[0] );
+                }
+                update_check_from( o );
+                store_rng( o, rng );
+            }
+
+            // Mutations of the tick
+            long long end_slot = ( tick + 1 ) * pop_size;
+            for ( int i = 0; i < n; i ++ ){
+                int o = first + i;
+                if ( !active[i] ) continue;
+                ticks[o] ++;
+                if ( next_mutation[o] >= end_slot ) continue;
+                xoshiro256 rng = load_rng( o );
+                int* population = &phenotypes[ (size_t) o * pop_size ];
+                while ( next_mutation[o] < end_slot ){
+                    population[ next_mutation[o] - tick * pop_size ] ^= 1 << rng.bounded( parameters.n_bits );
+                    advance_mutation( rng, o, next_mutation[o] + 1 );
+                }
+                store_rng( o, rng );
+            }
+        }
+    }
+
+private:
+    xoshiro256 load_rng( int o ) const {
+        xoshiro256 rng;
+        rng.s[0] = s0[o];
+        rng.s[1] = s1[o];
+        rng.s[2] = s2[o];
+        rng.s[3] = s3[o];
+        return( rng );
+    }
+
+    void store_rng( int o, const xoshiro256& rng ){
+        s0[o] = rng.s[0];
+        s1[o] = rng.s[1];
+        s2[o] = rng.s[2];
+        s3[o] = rng.s[3];
+    }
+
+    bool operates_schedule( int o, int alternative ) const {
+        const schedule_set& s = schedules[o];
+        return( s.mode == SCHEDULE_CONCURRENT ? alternative < (int) s.components.size() : alternative == 0 );
+    }
+
+    // Responses on interval schedules that are not armed leave the schedule as it is, so they are not passed on
+    void update_check_from( int o ){
+        check_from[o] = schedules[o].counts_responses() ? -std::numeric_limits<double>::infinity() : schedules[o].next_event_time();
+    }
+
+    void advance_mutation( xoshiro256& rng, int o, long long from ){
+        double gap = rng.geometric( parameters.mutation_rate );
+        double next = (double) from + gap;
+        next_mutation[o] = next >= 9.0e18 ? std::numeric_limits<long long>::max() : from + (long long) gap;
+    }
+
+    // As select_histogram and recombine_bitwise
+    void reproduce( xoshiro256& rng, int o, int target, fitness_histogram& histogram, int* fitness, int* fathers, int* mothers, int* children ){
+        int* population = &phenotypes[ (size_t) o * pop_size ];
+        int max_phenotype = ( 1 << parameters.n_bits ) - 1;
+        if ( parameters.distance == DISTANCE_WRAPPED ){
+            fitness_weights( population, pop_size, target, wrapped_distance( max_phenotype ), no_weight( 0 ), fitness, (double*) NULL );
+        } else {
+            fitness_weights( population, pop_size, target, unwrapped_distance( max_phenotype ), no_weight( 0 ), fitness, (double*) NULL );
+        }
+        build_fitness_histogram( fitness, pop_size, &parameters.weight_table[0], parameters.weight_table.size(), parameters.by_organism, histogram );
+        if ( !sample_parents( rng, histogram, pop_size, fathers, mothers ) ) return;
+
+        unsigned int mask = (unsigned int) max_phenotype;
+        for ( int i = 0; i < pop_size; i ++ ){
+            unsigned int from_father = (unsigned int) ( rng.next() >> 32 ) & mask;
+            children[i] = ( population[ fathers[i] ] & from_father ) | ( population[ mothers[i] ] & ~from_father & mask );
+        }
+        std::copy( children, children + pop_size, population );
+    }
+};
+
+#endif
@@ -0,0 +1,84 @@
+#include <Rcpp.h>
+#include <climits>
+#include "EBD_engine.h"
+#include "EBD_engine_state.h"
+#include "EBD_engine_R.h"
+using namespace Rcpp;
+
+static ebd_state ebd_state_from_raw( RawVector state ){
+    ebd_state restored;
+    if ( !read_ebd_state( RAW(state), state.length(), restored ) ){
+        stop( "'state' is not a snapshot of an EBD session." );
+    }
+    return( restored );
+}
+
+// Events are coded as in ebd_record, from 0. state is NULL to start from phenotypes, or a snapshot to resume from.
+// reseed draws a new RNG state from R's RNG for a resumed session instead of restoring the saved one.
+// [[Rcpp::export]]
+List CAB_cpp_EBD_session( List parameters, List components, List schedule, IntegerVector phenotypes, double ticks, int max_reinforcers, bool skip, SEXP state, bool reseed ){
+
+    ebd_parameters p = ebd_parameters_from_list( parameters );
+    schedule_set schedules = schedule_set_from_list( schedule );
+
+    if ( !( ticks >= 0 ) ){
+        stop( "'ticks' must not be negative." );
+    }
+
+    ebd_r_stages r;
+    ebd_pipeline pipeline = ebd_pipeline_from_list( components, r, true );
+
+    ebd_engine engine( p, schedules, seed_from_uniforms( R::unif_rand(), R::unif_rand() ), as< std::vector<int> >( phenotypes ), pipeline );
+    int64_t events = 0;
+    if ( Rf_isNull( state ) ){
+        engine.start();
+    } else {
+        ebd_state restored = ebd_state_from_raw( state );
+        if ( restored.n_bits != p.n_bits ){
+            stop( "The snapshot has %d bit genotypes but 'n_bits' is %d.", restored.n_bits, p.n_bits );
+        }
+        restore_ebd_state( restored, engine, reseed );
+        events = restored.events;
+    }
+
+    int max_phenotype = ( 1 << p.n_bits ) - 1;
+    if ( engine.pop_size() < 2 ){
+        stop( "The population needs at least two organisms." );
+    }
+    for ( int i = 0; i < engine.pop_size(); i ++ ){
+        if ( engine.phenotypes[i] < 0 || engine.phenotypes[i] > max_phenotype ){
+            stop( "Phenotype at position %d is outside [0, 2^n_bits - 1].", i + 1 );
+        }
+    }
+
+    ebd_record record;
+    long long first_tick = engine.tick;
+    int first_reinforcers = engine.reinforcers;
+    int reinforcer_limit = max_reinforcers > INT_MAX - first_reinforcers ? INT_MAX : first_reinforcers + max_reinforcers;
+    engine.run( first_tick + (long long) ticks, reinforcer_limit, skip, record );
+
+    events += record.time.size();
+    std::vector<unsigned char> snapshot = write_ebd_state( engine, events );
+    RawVector return_state( snapshot.size() );
+    std::copy( snapshot.begin(), snapshot.end(), return_state.begin() );
+
+    return( List::create(
+        Named("time") = record.time,
+        Named("event") = record.event,
+        Named("phenotypes") = engine.phenotypes,
+        Named("ticks") = (double) ( engine.tick - first_tick ),
+        Named("reinforcers") = engine.reinforcers - first_reinforcers,
+        Named("state") = return_state ) );
+}
+
+// [[Rcpp::export]]
+List CAB_cpp_EBD_state_info( RawVector state ){
+    ebd_state restored = ebd_state_from_raw( state );
+    return( List::create(
+        Named("n_bits") = restored.n_bits,
+        Named("tick") = (double) restored.tick,
+        Named("reinforcers") = restored.reinforcers,
+        Named("events") = (double) restored.events,
+        Named("link") = restored.schedules.link + 1,
+        Named("phenotypes") = restored.phenotypes ) );
+}
@@ -0,0 +1,399 @@
+#ifndef EBD_ENGINE_H
+#define EBD_ENGINE_H
+
+#include <vector>
+#include <cmath>
+#include <limits>
+#include "CAB_cpp_rng.h"
+#include "CAB_cpp_schedules.h"
+#include "CAB_cpp_profile.h"
+#include "EBD_fitness.h"
+#include "EBD_selection.h"
+#include "EBD_operant_classes.h"
+
+// A compiled EBD session.
+// Every tick one organism, chosen uniformly, emits its phenotype. Phenotypes in the class of an alternative
+// are responses on that alternative and operate the schedule. A reinforced response selects parents by
+// fitness to the response and replaces the population with their children. Every tick then mutates each
+// organism with probability mutation_rate by flipping one of its bits, as EBD_B_premutate does.
+//
+// run() has two modes that give the same distribution of sessions:
+//  - tick by tick, with a Binomial( pop_size, mutation_rate ) number of mutants drawn every tick.
+//  - skipping. Mutations are Bernoulli trials over the slots tick * pop_size + organism, so they are drawn
+//    for many ticks at once by skipping between successful slots with geometric waiting times. While no
+//    response can change the schedule (an interval schedule that is not yet armed), the emitters of the
+//    whole run are drawn at once and the schedule is not consulted. Per-tick work resumes at the next
+//    schedule event, and with ratio schedules, at every response.
+//
+// The stages of a model are bound once into an ebd_pipeline of function pointers, so each stage is a direct
+// call. The stock stages follow the engine. Other stages, such as the R functions bound in EBD_engine_R.h,
+// only need to match the signatures.
+
+struct ebd_parameters {
+    int n_bits;
+    double mutation_rate;
+    int distance;
+    bool by_organism;                   // see build_fitness_histogram
+    std::vector<double> weight_table;   // weight of every fitness, see fill_weight_table
+    std::vector<int> class_lower;       // inclusive phenotype bounds of the class of each alternative
+    std::vector<int> class_upper;
+};
+
+// Events are coded as: a = response on alternative a, n_alternatives + a = reinforcer on alternative a,
+// 2 * n_alternatives = a link of a chained schedule completed
+struct ebd_record {
+    std::vector<double> time;
+    std::vector<int> event;
+
+    void push( double t, int e ){
+        time.push_back( t );
+        event.push_back( e );
+    }
+};
+
+// Emitters of an idle run are drawn in blocks of this many ticks
+static const int EBD_EMITTER_BLOCK = 4096;
+
+class ebd_engine;
+
+struct ebd_pipeline {
+    int ( *emit )( ebd_engine& engine );                                    // the organism that emits
+    void ( *fitness )( ebd_engine& engine, int target, int* fitness );      // fitness of every organism to target
+    bool ( *select )( ebd_engine& engine, const int* fitness, int* fathers, int* mothers );   // false if no parents
+    void ( *recombine )( ebd_engine& engine, const int* fathers, const int* mothers, int* children );
+    void ( *mutate )( ebd_engine& engine, int organism );
+    void* data;     // for stages that need more than the engine
+
+    // emit_prp_race: the lower phenotype of each operant class and the size of the race
+    std::vector<int> oc_lower;
+    int prp_size;
+};
+
+// Stock stages
+inline int emit_uniform( ebd_engine& engine );
+inline int emit_prp_race( ebd_engine& engine );
+inline void fitness_distance( ebd_engine& engine, int target, int* fitness );
+inline bool select_histogram( ebd_engine& engine, const int* fitness, int* fathers, int* mothers );
+inline bool select_random( ebd_engine& engine, const int* fitness, int* fathers, int* mothers );
+inline void recombine_bitwise( ebd_engine& engine, const int* fathers, const int* mothers, int* children );
+inline void mutate_bit_flip( ebd_engine& engine, int organism );
+inline void mutate_uniform( ebd_engine& engine, int organism );
+
+inline ebd_pipeline ebd_stock_pipeline(){
+    ebd_pipeline pipeline;
+    pipeline.emit = emit_uniform;
+    pipeline.fitness = fitness_distance;
+    pipeline.select = select_histogram;
+    pipeline.recombine = recombine_bitwise;
+    pipeline.mutate = mutate_bit_flip;
+    pipeline.data = NULL;
+    pipeline.prp_size = 0;
+    return( pipeline );
+}
+
+class ebd_engine {
+public:
+    ebd_parameters parameters;
+    schedule_set schedules;
+    xoshiro256 rng;
+    std::vector<int> phenotypes;
+    long long tick;
+    long long next_mutation;    // skipping mode: the slot of the next mutation, or -1 if none is drawn
+    int reinforcers;
+    ebd_pipeline pipeline;
+
+    // Operant classes of the population, kept up to date through mutations for emit_prp_race. Set
+    // operant_classes_stale after changing phenotypes from outside the engine.
+    operant_class_index operant_classes;
+    bool operant_classes_stale;
+
+    // Scratch for the stages
+    fitness_histogram histogram;
+    std::vector<int> race;
+
+    ebd_engine( const ebd_parameters& parameters, const schedule_set& schedules, uint64_t seed, const std::vector<int>& phenotypes,
+        const ebd_pipeline& pipeline = ebd_stock_pipeline() ) :
+        parameters( parameters ), schedules( schedules ), rng( seed ), phenotypes( phenotypes ), tick( 0 ), next_mutation( -1 ), reinforcers( 0 ),
+        pipeline( pipeline ), operant_classes_stale( true ) {
+        operant_classes.set_classes( pipeline.oc_lower );
+    }
+
+    int max_phenotype() const {
+        return( ( 1 << parameters.n_bits ) - 1 );
+    }
+
+    int pop_size() const {
+        return( phenotypes.size() );
+    }
+
+    int n_alternatives() const {
+        return( parameters.class_lower.size() );
+    }
+
+    void start(){
+        schedules.start( rng, (double) tick );
+        next_mutation = -1;
+    }
+
+    // Run until end_tick or until max_reinforcers reinforcers have been delivered in total
+    void run( long long end_tick, int max_reinforcers, bool skip, ebd_record& record ){
+        if ( skip ){
+            run_skipping( end_tick, max_reinforcers, record );
+        } else {
+            run_ticks( end_tick, max_reinforcers, record );
+        }
+    }
+
+private:
+    std::vector<int> fitness;
+    std::vector<int> fathers;
+    std::vector<int> mothers;
+    std::vector<int> children;
+    std::vector<int> mutants;
+    std::vector<int> permutation;
+    std::vector<int> emitters;
+
+    // The alternative whose class holds phenotype, or -1
+    int classify( int phenotype ) const {
+        for ( int a = 0; a < n_alternatives(); a ++ ){
+            if ( phenotype >= parameters.class_lower[a] && phenotype <= parameters.class_upper[a] ) return( a );
+        }
+        return( -1 );
+    }
+
+    bool operates_schedule( int alternative ) const {
+        return( schedules.mode == SCHEDULE_CONCURRENT ? alternative < (int) schedules.components.size() : alternative == 0 );
+    }
+
+    // Emission by organism with the schedule consulted
+    void respond( int organism, ebd_record& record ){
+        int phenotype = phenotypes[ organism ];
+        int alternative = classify( phenotype );
+        if ( alternative < 0 ) return;
+        record.push( (double) tick, alternative );
+        if ( !operates_schedule( alternative ) ) return;
+
+        int outcome = schedules.response( rng, alternative, (double) tick );
+        if ( outcome == OUTCOME_LINK ){
+            record.push( (double) tick, 2 * n_alternatives() );
+        } else if ( outcome == OUTCOME_REINFORCER ){
+            record.push( (double) tick, n_alternatives() + alternative );
+            reinforcers ++;
+            reproduce( phenotype );
+        }
+    }
+
+    void reproduce( int target ){
+        int n = pop_size();
+        fitness.resize( n );
+        fathers.resize( n );
+        mothers.resize( n );
+        children.resize( n );
+        {
+            CAB_PROFILE_SCOPE( PROFILE_FITNESS );
+            pipeline.fitness( *this, target, &fitness[0] );
+        }
+        {
+            CAB_PROFILE_SCOPE( PROFILE_SELECTION );
+            // Without parents the population is kept
+            if ( !pipeline.select( *this, &fitness[0], &fathers[0], &mothers[0] ) ) return;
+        }
+        CAB_PROFILE_SCOPE( PROFILE_RECOMBINATION );
+        pipeline.recombine( *this, &fathers[0], &mothers[0], &children[0] );
+        phenotypes.swap( children );
+        // Every organism is replaced, so the classes are rebuilt when next needed
+        operant_classes_stale = true;
+    }
+
+    void mutate( int organism ){
+        pipeline.mutate( *this, organism );
+        if ( !operant_classes_stale && pipeline.emit == emit_prp_race ){
+            operant_classes.update( organism, phenotypes[ organism ] );
+        }
+    }
+
+    void run_ticks( long long end_tick, int max_reinforcers, ebd_record& record ){
+        int n = pop_size();
+        mutants.resize( n );
+        while ( tick < end_tick && reinforcers < max_reinforcers ){
+            {
+                CAB_PROFILE_SCOPE( PROFILE_EMISSION );
+                respond( pipeline.emit( *this ), record );
+            }
+            CAB_PROFILE_SCOPE( PROFILE_MUTATION );
+            int m = rng.binomial( n, parameters.mutation_rate );
+            // The scratch permutation is reset, so that mutants do not depend on state outside a snapshot
+            if ( m <= 64 ){
+                floyd_sample( rng, n, m, &mutants[0] );
+            } else {
+                permutation.clear();
+                partial_fisher_yates( rng, permutation, n, m, &mutants[0] );
+            }
+            for ( int i = 0; i < m; i ++ ){
+                mutate( mutants[i] );
+            }
+            tick ++;
+        }
+    }
+
+    // Slots from the current mutation to the next, as a slot index that saturates instead of overflowing
+    void advance_mutation( long long from ){
+        double gap = rng.geometric( parameters.mutation_rate );
+        double next = (double) from + gap;
+        next_mutation = next >= 9.0e18 ? std::numeric_limits<long long>::max() : from + (long long) gap;
+    }
+
+    // The mutations of the current tick
+    void mutate_slots(){
+        long long n = pop_size();
+        long long end_slot = ( tick + 1 ) * n;
+        while ( next_mutation < end_slot ){
+            mutate( (int) ( next_mutation - tick * n ) );
+            advance_mutation( next_mutation + 1 );
+        }
+    }
+
+    void run_skipping( long long end_tick, int max_reinforcers, ebd_record& record ){
+        int n = pop_size();
+        if ( parameters.mutation_rate <= 0 ){
+            next_mutation = std::numeric_limits<long long>::max();
+        } else if ( next_mutation < tick * n ){
+            // Slots are independent, so a stream from an earlier run is simply restarted
+            advance_mutation( tick * n );
+        }
+
+        while ( tick < end_tick && reinforcers < max_reinforcers ){
+
+            // Ticks before the next schedule event, where no response can be reinforced
+            long long idle_end = tick;
+            if ( !schedules.counts_responses() ){
+                double next = schedules.next_event_time();
+                idle_end = next >= (double) end_tick ? end_tick : std::max( tick, (long long) std::ceil( next ) );
+            }
+
+            if ( idle_end > tick ){
+                run_idle( idle_end, record );
+                continue;
+            }
+
+            {
+                CAB_PROFILE_SCOPE( PROFILE_EMISSION );
+                respond( pipeline.emit( *this ), record );
+            }
+            CAB_PROFILE_SCOPE( PROFILE_MUTATION );
+            mutate_slots();
+            tick ++;
+        }
+    }
+
+    // Emission and mutation without consulting the schedule. Uniform emitters are drawn a block at a time.
+    void run_idle( long long end_tick, ebd_record& record ){
+        int n = pop_size();
+        bool uniform = pipeline.emit == emit_uniform;
+        emitters.resize( EBD_EMITTER_BLOCK );
+        while ( tick < end_tick ){
+            int block = end_tick - tick < EBD_EMITTER_BLOCK ? (int) ( end_tick - tick ) : EBD_EMITTER_BLOCK;
+            if ( uniform ){
+                for ( int i = 0; i < block; i ++ ){
+                    emitters[i] = rng.bounded( n );
+                }
+            }
+            for ( int i = 0; i < block; i ++ ){
+                int alternative = classify( phenotypes[ uniform ? emitters[i] : pipeline.emit( *this ) ] );
+                if ( alternative >= 0 ) record.push( (double) tick, alternative );
+                mutate_slots();
+                tick ++;
+            }
+        }
+    }
+};
+
+inline int emit_uniform( ebd_engine& engine ){
+    return( engine.rng.bounded( engine.pop_size() ) );
+}
+
+// A race between operant classes, as EBD_prp_race. Each class with members draws a Negative Binomial
+// ( prp_size, share of the population ) PRP and the emitter is drawn uniformly from the members of the
+// classes with the shortest. O( n_classes * prp_size ) with the classes kept up to date by the engine.
+// One emission is still one tick: the race picks the emitter but does not delay it.
+inline int emit_prp_race( ebd_engine& engine ){
+    operant_class_index& classes = engine.operant_classes;
+    if ( engine.operant_classes_stale ){
+        classes.build( engine.phenotypes );
+        engine.operant_classes_stale = false;
+    }
+
+    int n_classes = classes.n_classes();
+    engine.race.resize( n_classes );
+    int fastest = -1;
+    int pooled = 0;
+    for ( int c = 0; c < n_classes; c ++ ){
+        int count = classes.count( c );
+        if ( count == 0 ) continue;
+        int prp = (int) engine.rng.negative_binomial( engine.pipeline.prp_size, (double) count / engine.pop_size() );
+        engine.race[c] = prp;
+        if ( fastest < 0 || prp < fastest ){
+            fastest = prp;
+            pooled = count;
+        } else if ( prp == fastest ){
+            pooled += count;
+        }
+    }
+
+    // Classes that tie for the fastest PRP are pooled
+    int pick = engine.rng.bounded( pooled );
+    for ( int c = 0; c < n_classes; c ++ ){
+        if ( classes.count( c ) == 0 || engine.race[c] != fastest ) continue;
+        if ( pick < classes.count( c ) ) return( classes.members[c][ pick ] );
+        pick -= classes.count( c );
+    }
+    return( 0 );
+}
+
+inline void fitness_distance( ebd_engine& engine, int target, int* fitness ){
+    const int* phenotypes = &engine.phenotypes[0];
+    if ( engine.parameters.distance == DISTANCE_WRAPPED ){
+        fitness_weights( phenotypes, engine.pop_size(), target, wrapped_distance( engine.max_phenotype() ), no_weight( 0 ), fitness, (double*) NULL );
+    } else {
+        fitness_weights( phenotypes, engine.pop_size(), target, unwrapped_distance( engine.max_phenotype() ), no_weight( 0 ), fitness, (double*) NULL );
+    }
+}
+
+// Parents by the weight table, see build_fitness_histogram
+inline bool select_histogram( ebd_engine& engine, const int* fitness, int* fathers, int* mothers ){
+    const ebd_parameters& p = engine.parameters;
+    build_fitness_histogram( fitness, engine.pop_size(), &p.weight_table[0], p.weight_table.size(), p.by_organism, engine.histogram );
+    return( sample_parents( engine.rng, engine.histogram, engine.pop_size(), fathers, mothers ) );
+}
+
+// Parents uniformly, with the mother different from the father
+inline bool select_random( ebd_engine& engine, const int*, int* fathers, int* mothers ){
+    int n = engine.pop_size();
+    for ( int i = 0; i < n; i ++ ){
+        fathers[i] = engine.rng.bounded( n );
+        mothers[i] = engine.rng.bounded( n - 1 );
+        if ( mothers[i] >= fathers[i] ) mothers[i] ++;
+    }
+    return( true );
+}
+
+// Each bit of a child comes from the father or the mother with probability 1/2
+inline void recombine_bitwise( ebd_engine& engine, const int* fathers, const int* mothers, int* children ){
+    unsigned int mask = (unsigned int) engine.max_phenotype();
+    const int* phenotypes = &engine.phenotypes[0];
+    for ( int i = 0; i < engine.pop_size(); i ++ ){
+        unsigned int from_father = (unsigned int) ( engine.rng.next() >> 32 ) & mask;
+        children[i] = ( phenotypes[ fathers[i] ] & from_father ) | ( phenotypes[ mothers[i] ] & ~from_father & mask );
+    }
+}
+
+inline void mutate_bit_flip( ebd_engine& engine, int organism ){
+    engine.phenotypes[ organism ] ^= 1 << engine.rng.bounded( engine.parameters.n_bits );
+}
+
+// A new phenotype drawn uniformly
+inline void mutate_uniform( ebd_engine& engine, int organism ){
+    engine.phenotypes[ organism ] = engine.rng.bounded( engine.max_phenotype() + 1u );
+}
+
+#endif
@@ -0,0 +1,168 @@
+#ifndef EBD_ENGINE_R_H
+#define EBD_ENGINE_R_H
+
+#include <Rcpp.h>
+#include "EBD_engine.h"
+#include "CAB_cpp_schedules_R.h"
+
+// Engine parameters from the list made by EBD_session_parameters(). Call on the main thread, before any threads start.
+inline ebd_parameters ebd_parameters_from_list( Rcpp::List parameters ){
+    ebd_parameters p;
+    p.n_bits = Rcpp::as<int>( parameters["n_bits"] );
+    p.mutation_rate = Rcpp::as<double>( parameters["mutation_rate"] );
+    p.distance = Rcpp::as<int>( parameters["distance_code"] );
+    p.by_organism = Rcpp::as<bool>( parameters["by_organism"] );
+    p.weight_table = Rcpp::as< std::vector<double> >( parameters["weight_table"] );
+    p.class_lower = Rcpp::as< std::vector<int> >( parameters["class_lower"] );
+    p.class_upper = Rcpp::as< std::vector<int> >( parameters["class_upper"] );
+
+    if ( p.n_bits < 1 || p.n_bits > 30 ){
+        Rcpp::stop( "'n_bits' must be between 1 and 30." );
+    }
+    if ( !( p.mutation_rate >= 0 && p.mutation_rate <= 1 ) ){
+        Rcpp::stop( "'mutation_rate' must be between 0 and 1." );
+    }
+    if ( (int) p.weight_table.size() < max_fitness( ( 1 << p.n_bits ) - 1, p.distance ) + 1 ){
+        Rcpp::stop( "The weight table is too short for 'n_bits'." );
+    }
+    if ( p.class_lower.empty() || p.class_lower.size() != p.class_upper.size() ){
+        Rcpp::stop( "Every alternative needs a lower and an upper phenotype." );
+    }
+    return( p );
+}
+
+// Stages written in R, the slower fallback for stages without a compiled version. They call back into R,
+// so pipelines with them only run on the main thread.
+struct ebd_r_stages {
+    SEXP emission;
+    SEXP fitness;
+    SEXP selection;
+    SEXP recombination;
+    SEXP mutation;
+};
+
+inline ebd_r_stages& r_stages( ebd_engine& engine ){
+    return( *(ebd_r_stages*) engine.pipeline.data );
+}
+
+inline void check_phenotypes( const Rcpp::IntegerVector& phenotypes, int n, int max_phenotype, const char* stage ){
+    if ( phenotypes.length() != n ){
+        Rcpp::stop( "The %s stage must return %d values.", stage, n );
+    }
+    for ( int i = 0; i < n; i ++ ){
+        if ( phenotypes[i] < 0 || phenotypes[i] > max_phenotype ){
+            Rcpp::stop( "The %s stage returned %d, which is outside [0, %d].", stage, phenotypes[i], max_phenotype );
+        }
+    }
+}
+
+// function( phenotypes ) returning the index of the emitter, from 1
+inline int r_emit( ebd_engine& engine ){
+    int organism = Rcpp::as<int>( Rcpp::Function( r_stages( engine ).emission )( engine.phenotypes ) ) - 1;
+    if ( organism < 0 || organism >= engine.pop_size() ){
+        Rcpp::stop( "The emission stage must return an index between 1 and the population size." );
+    }
+    return( organism );
+}
+
+// function( phenotypes, target ) returning the fitness of every organism
+inline void r_fitness( ebd_engine& engine, int target, int* fitness ){
+    Rcpp::IntegerVector values = Rcpp::Function( r_stages( engine ).fitness )( engine.phenotypes, target );
+    check_phenotypes( values, engine.pop_size(), engine.parameters.weight_table.size() - 1, "fitness" );
+    std::copy( values.begin(), values.end(), fitness );
+}
+
+// function( fitness, n_pairs ) returning a matrix with the indices of fathers and mothers, from 1, or NULL for no parents
+inline bool r_select( ebd_engine& engine, const int* fitness, int* fathers, int* mothers ){
+    int n = engine.pop_size();
+    SEXP parents = Rcpp::Function( r_stages( engine ).selection )( Rcpp::IntegerVector( fitness, fitness + n ), n );
+    if ( Rf_isNull( parents ) ) return( false );
+    Rcpp::IntegerMatrix matrix( parents );
+    if ( matrix.nrow() != n || matrix.ncol() != 2 ){
+        Rcpp::stop( "The selection stage must return a matrix with a row for each organism and two columns." );
+    }
+    for ( int i = 0; i < n; i ++ ){
+        fathers[i] = matrix( i, 0 ) - 1;
+        mothers[i] = matrix( i, 1 ) - 1;
+        if ( fathers[i] < 0 || fathers[i] >= n || mothers[i] < 0 || mothers[i] >= n ){
+            Rcpp::stop( "The selection stage must return indices between 1 and the population size." );
+        }
+    }
+    return( true );
+}
+
+// function( fathers, mothers ) of the parents' phenotypes, returning the children's phenotypes
+inline void r_recombine( ebd_engine& engine, const int* fathers, const int* mothers, int* children ){
+    int n = engine.pop_size();
+    Rcpp::IntegerVector father_phenotypes( n ), mother_phenotypes( n );
+    for ( int i = 0; i < n; i ++ ){
+        father_phenotypes[i] = engine.phenotypes[ fathers[i] ];
+        mother_phenotypes[i] = engine.phenotypes[ mothers[i] ];
+    }
+    Rcpp::IntegerVector values = Rcpp::Function( r_stages( engine ).recombination )( father_phenotypes, mother_phenotypes );
+    check_phenotypes( values, n, engine.max_phenotype(), "recombination" );
+    std::copy( values.begin(), values.end(), children );
+}
+
+// function( phenotype ) returning the mutated phenotype
+inline void r_mutate( ebd_engine& engine, int organism ){
+    Rcpp::IntegerVector value = Rcpp::Function( r_stages( engine ).mutation )( engine.phenotypes[ organism ] );
+    check_phenotypes( value, 1, engine.max_phenotype(), "mutation" );
+    engine.phenotypes[ organism ] = value[0];
+}
+
+// Stage codes, as in EBD_components() in R
+enum ebd_stage_code { STAGE_R = -1 };
+enum ebd_emission_code { EMISSION_UNIFORM, EMISSION_PRP_RACE };
+enum ebd_selection_code { SELECTION_HISTOGRAM, SELECTION_RANDOM };
+enum ebd_mutation_code { MUTATION_BIT_FLIP, MUTATION_UNIFORM };
+
+// Binds the stages made by EBD_components() into a pipeline. R functions are kept in r, which must outlive
+// the pipeline. With allow_r false, R functions are an error.
+inline ebd_pipeline ebd_pipeline_from_list( Rcpp::List components, ebd_r_stages& r, bool allow_r ){
+    ebd_pipeline pipeline = ebd_stock_pipeline();
+    pipeline.data = &r;
+
+    const char* names[5] = { "emission", "fitness", "selection", "recombination", "mutation" };
+    SEXP* functions[5] = { &r.emission, &r.fitness, &r.selection, &r.recombination, &r.mutation };
+    int codes[5];
+    for ( int i = 0; i < 5; i ++ ){
+        SEXP component = components[ names[i] ];
+        *functions[i] = R_NilValue;
+        if ( Rf_isFunction( component ) ){
+            if ( !allow_r ){
+                Rcpp::stop( "The %s stage is an R function, which cannot run in threads.", names[i] );
+            }
+            *functions[i] = component;
+            codes[i] = STAGE_R;
+        } else {
+            codes[i] = Rcpp::as<int>( component );
+        }
+    }
+
+    if ( codes[0] == STAGE_R ) pipeline.emit = r_emit;
+    if ( codes[0] == EMISSION_PRP_RACE ){
+        pipeline.emit = emit_prp_race;
+        pipeline.oc_lower = Rcpp::as< std::vector<int> >( components["oc_lower"] );
+        pipeline.prp_size = Rcpp::as<int>( components["prp_size"] );
+        bool increasing = !pipeline.oc_lower.empty() && pipeline.oc_lower[0] == 0;
+        for ( size_t c = 1; c < pipeline.oc_lower.size() && increasing; c ++ ){
+            increasing = pipeline.oc_lower[c] > pipeline.oc_lower[c-1];
+        }
+        if ( !increasing ){
+            Rcpp::stop( "'oc_lower' must be increasing from 0." );
+        }
+        if ( pipeline.prp_size < 1 ){
+            Rcpp::stop( "'prp_size' must be at least 1." );
+        }
+    }
+    if ( codes[1] == STAGE_R ) pipeline.fitness = r_fitness;
+    if ( codes[2] == STAGE_R ) pipeline.select = r_select;
+    if ( codes[2] == SELECTION_RANDOM ) pipeline.select = select_random;
+    if ( codes[3] == STAGE_R ) pipeline.recombine = r_recombine;
+    if ( codes[4] == STAGE_R ) pipeline.mutate = r_mutate;
+    if ( codes[4] == MUTATION_UNIFORM ) pipeline.mutate = mutate_uniform;
+    return( pipeline );
+}
+
+#endif
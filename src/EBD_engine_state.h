@@ -0,0 +1,200 @@
+#ifndef EBD_ENGINE_STATE_H
+#define EBD_ENGINE_STATE_H
+
+#include <vector>
+#include <cstring>
+#include <stdint.h>
+#include "EBD_engine.h"
+
+// Binary snapshots of an ebd_engine, for resuming or forking long runs.
+// A snapshot holds the population with its genotypes packed n_bits at a time, the RNG state, the tick,
+// the position of the mutation stream, the schedule state and the number of events recorded so far.
+// The model parameters are not in the snapshot, so a restored population can be run under new ones.
+// The layout is native endian and is meant for the machine and package version that wrote it.
+
+static const char EBD_STATE_MAGIC[4] = { 'C', 'A', 'B', 'E' };
+static const int32_t EBD_STATE_VERSION = 1;
+
+class state_writer {
+public:
+    std::vector<unsigned char> bytes;
+
+    template <typename T>
+    void put( const T& x ){
+        size_t at = bytes.size();
+        bytes.resize( at + sizeof(T) );
+        std::memcpy( &bytes[at], &x, sizeof(T) );
+    }
+};
+
+class state_reader {
+public:
+    const unsigned char* bytes;
+    size_t size;
+    size_t at;
+
+    state_reader( const unsigned char* bytes, size_t size ) : bytes( bytes ), size( size ), at( 0 ) {}
+
+    // false when the snapshot is too short
+    template <typename T>
+    bool get( T& x ){
+        if ( size - at < sizeof(T) ) return( false );
+        std::memcpy( &x, bytes + at, sizeof(T) );
+        at += sizeof(T);
+        return( true );
+    }
+};
+
+inline void write_schedule( state_writer& out, const schedule& s ){
+    out.put( (int32_t) s.spec.type );
+    out.put( s.spec.value );
+    out.put( s.spec.shift );
+    out.put( s.spec.min_irt );
+    out.put( (int32_t) s.spec.n_intervals );
+    out.put( s.armed_time );
+    out.put( (int32_t) s.remaining );
+    out.put( (int32_t) s.cursor );
+    out.put( (int32_t) s.progression.size() );
+    for ( size_t i = 0; i < s.progression.size(); i ++ ) out.put( s.progression[i] );
+}
+
+inline bool read_schedule( state_reader& in, schedule& s ){
+    int32_t type, n_intervals, remaining, cursor, n_progression;
+    bool ok = in.get( type ) && in.get( s.spec.value ) && in.get( s.spec.shift ) && in.get( s.spec.min_irt ) &&
+        in.get( n_intervals ) && in.get( s.armed_time ) && in.get( remaining ) && in.get( cursor ) && in.get( n_progression );
+    if ( !ok || n_progression < 0 || (size_t) n_progression > ( in.size - in.at ) / sizeof(double) ) return( false );
+    s.spec.type = type;
+    s.spec.n_intervals = n_intervals;
+    s.remaining = remaining;
+    s.cursor = cursor;
+    if ( type == SCHEDULE_VI_FLESHLER_HOFFMAN && ( n_progression != n_intervals || cursor < 0 || cursor > n_intervals ) ) return( false );
+    s.progression.resize( n_progression );
+    for ( int i = 0; i < n_progression; i ++ ){
+        if ( !in.get( s.progression[i] ) ) return( false );
+    }
+    return( true );
+}
+
+inline bool same_spec( const schedule_spec& a, const schedule_spec& b ){
+    return( a.type == b.type && a.value == b.value && a.shift == b.shift && a.min_irt == b.min_irt && a.n_intervals == b.n_intervals );
+}
+
+inline bool same_schedule( const schedule_set& a, const schedule_set& b ){
+    if ( a.mode != b.mode || a.components.size() != b.components.size() ) return( false );
+    for ( size_t i = 0; i < a.components.size(); i ++ ){
+        if ( !same_spec( a.components[i].spec, b.components[i].spec ) ) return( false );
+    }
+    return( true );
+}
+
+inline std::vector<unsigned char> write_ebd_state( const ebd_engine& engine, int64_t events ){
+    state_writer out;
+    for ( int i = 0; i < 4; i ++ ) out.put( EBD_STATE_MAGIC[i] );
+    out.put( EBD_STATE_VERSION );
+    out.put( (int32_t) engine.parameters.n_bits );
+    out.put( (int32_t) engine.pop_size() );
+    out.put( (int64_t) engine.tick );
+    out.put( (int64_t) engine.next_mutation );
+    out.put( (int32_t) engine.reinforcers );
+    out.put( events );
+    for ( int i = 0; i < 4; i ++ ) out.put( engine.rng.s[i] );
+
+    out.put( (int32_t) engine.schedules.mode );
+    out.put( (int32_t) engine.schedules.link );
+    out.put( (int32_t) engine.schedules.components.size() );
+    for ( size_t i = 0; i < engine.schedules.components.size(); i ++ ){
+        write_schedule( out, engine.schedules.components[i] );
+    }
+
+    // Genotypes as one stream of n_bits bit fields
+    int n_bits = engine.parameters.n_bits;
+    size_t at = out.bytes.size();
+    out.bytes.resize( at + ( (size_t) engine.pop_size() * n_bits + 7 ) / 8, 0 );
+    unsigned char* packed = &out.bytes[at];
+    size_t bit = 0;
+    for ( int i = 0; i < engine.pop_size(); i ++ ){
+        uint32_t genotype = engine.phenotypes[i];
+        for ( int b = 0; b < n_bits; b ++, bit ++ ){
+            packed[ bit >> 3 ] |= ( ( genotype >> b ) & 1u ) << ( bit & 7 );
+        }
+    }
+    return( out.bytes );
+}
+
+// Everything in a snapshot, before it is put into an engine
+struct ebd_state {
+    int n_bits;
+    int64_t tick;
+    int64_t next_mutation;
+    int reinforcers;
+    int64_t events;
+    uint64_t s[4];
+    schedule_set schedules;
+    std::vector<int> phenotypes;
+};
+
+// false for snapshots that are truncated or not snapshots
+inline bool read_ebd_state( const unsigned char* bytes, size_t size, ebd_state& state ){
+    state_reader in( bytes, size );
+    char magic[4];
+    int32_t version, n_bits, pop_size, reinforcers, mode, link, n_components;
+    for ( int i = 0; i < 4; i ++ ){
+        if ( !in.get( magic[i] ) || magic[i] != EBD_STATE_MAGIC[i] ) return( false );
+    }
+    if ( !in.get( version ) || version != EBD_STATE_VERSION ) return( false );
+    bool ok = in.get( n_bits ) && in.get( pop_size ) && in.get( state.tick ) && in.get( state.next_mutation ) &&
+        in.get( reinforcers ) && in.get( state.events );
+    for ( int i = 0; i < 4 && ok; i ++ ) ok = in.get( state.s[i] );
+    ok = ok && in.get( mode ) && in.get( link ) && in.get( n_components );
+    if ( !ok || n_bits < 1 || n_bits > 30 || pop_size < 0 || n_components < 0 ) return( false );
+
+    state.n_bits = n_bits;
+    state.reinforcers = reinforcers;
+    state.schedules.mode = mode;
+    state.schedules.link = link;
+    state.schedules.components.clear();
+    for ( int i = 0; i < n_components; i ++ ){
+        schedule s;
+        if ( !read_schedule( in, s ) ) return( false );
+        state.schedules.components.push_back( s );
+    }
+    if ( link < 0 || ( n_components > 0 && link >= n_components ) ) return( false );
+
+    size_t n_packed = ( (size_t) pop_size * n_bits + 7 ) / 8;
+    if ( size - in.at < n_packed ) return( false );
+    const unsigned char* packed = bytes + in.at;
+    state.phenotypes.assign( pop_size, 0 );
+    size_t bit = 0;
+    for ( int i = 0; i < pop_size; i ++ ){
+        uint32_t genotype = 0;
+        for ( int b = 0; b < n_bits; b ++, bit ++ ){
+            genotype |= (uint32_t) ( ( packed[ bit >> 3 ] >> ( bit & 7 ) ) & 1u ) << b;
+        }
+        state.phenotypes[i] = genotype;
+    }
+    return( true );
+}
+
+// Puts a snapshot into an engine made with the new parameters and schedule. The schedule state is kept
+// when the schedule is unchanged. Otherwise the new schedule starts at the snapshot tick.
+// With reseed, the engine keeps its own seed and draws a new mutation position, so sessions forked
+// from one snapshot are independent. Otherwise the saved RNG state is restored.
+inline void restore_ebd_state( const ebd_state& state, ebd_engine& engine, bool reseed ){
+    engine.phenotypes = state.phenotypes;
+    engine.operant_classes_stale = true;
+    engine.tick = state.tick;
+    engine.reinforcers = state.reinforcers;
+    if ( reseed ){
+        engine.next_mutation = -1;
+    } else {
+        engine.next_mutation = state.next_mutation;
+        for ( int i = 0; i < 4; i ++ ) engine.rng.s[i] = state.s[i];
+    }
+    if ( same_schedule( engine.schedules, state.schedules ) ){
+        engine.schedules = state.schedules;
+    } else {
+        engine.schedules.start( engine.rng, (double) engine.tick );
+    }
+}
+
+#endif
@@ -0,0 +1,121 @@
+#include <Rcpp.h>
+#include "EBD_fitness.h"
+#include "EBD_selection.h"
+#include "CAB_cpp_profile.h"
+using namespace Rcpp;
+
+// The geometric weights take a probability in (0, 1] and the exponential and linear weights a positive mean
+static void check_weight_parameter( int weight, double parameter ){
+    if ( weight == WEIGHT_GEOMETRIC && !( parameter > 0 && parameter <= 1 ) ){
+        stop( "The geometric weights need a probability in (0, 1]." );
+    }
+    if ( ( weight == WEIGHT_EXPONENTIAL || weight == WEIGHT_LINEAR ) && !( parameter > 0 && R_finite( parameter ) ) ){
+        stop( "The exponential and linear weights need a positive, finite mean." );
+    }
+}
+
+// distance: 0 = wrapped, 1 = unwrapped
+// weight: 0 = geometric, 1 = exponential, 2 = linear, 3 = none
+// [[Rcpp::export]]
+List CAB_cpp_EBD_fitness_weights( IntegerVector phenotypes, int target, int max_phenotype, int distance, int weight, double parameter ){
+
+    CAB_PROFILE_SCOPE( PROFILE_FITNESS );
+    check_weight_parameter( weight, parameter );
+
+    int n = phenotypes.length();
+    IntegerVector fitness( n );
+    NumericVector weights( weight == WEIGHT_NONE ? 0 : n );
+
+    for ( int i = 0; i < n; i ++ ){
+        if ( phenotypes[i] == NA_INTEGER ){
+            stop( "Phenotypes must not be NA." );
+        }
+    }
+
+    fitness_weights_dispatch( INTEGER(phenotypes), n, target, max_phenotype, distance, weight, parameter, INTEGER(fitness), weight == WEIGHT_NONE ? NULL : REAL(weights) );
+
+    return( List::create( Named("fitness") = fitness, Named("weights") = weights ) );
+}
+
+// Weights of every fitness from 0 to the largest that distance can give
+// [[Rcpp::export]]
+NumericVector CAB_cpp_EBD_weight_table( int max_phenotype, int distance, int weight, double parameter ){
+    if ( max_phenotype < 0 ) stop( "'max_phenotype' must not be negative." );
+    check_weight_parameter( weight, parameter );
+    NumericVector table( max_fitness( max_phenotype, distance ) + 1 );
+    fill_weight_table_dispatch( weight, parameter, table.length(), REAL(table) );
+    return( table );
+}
+
+// Weights feed the selection histogram, which needs them to be numbers that are not negative
+static void check_weight_table( NumericVector table ){
+    for ( int f = 0; f < table.length(); f ++ ){
+        if ( !( table[f] >= 0 ) ){
+            stop( "The weight for fitness %d is missing or negative.", f );
+        }
+    }
+}
+
+static void check_fitness_range( const int* fitness, int n, int n_fitness ){
+    for ( int i = 0; i < n; i ++ ){
+        if ( fitness[i] < 0 || fitness[i] >= n_fitness ){
+            stop( "Fitness %d at position %d is outside the weight table.", fitness[i], i + 1 );
+        }
+    }
+}
+
+// [[Rcpp::export]]
+List CAB_cpp_EBD_table_fitness_weights( IntegerVector phenotypes, int target, int max_phenotype, int distance, NumericVector table ){
+
+    CAB_PROFILE_SCOPE( PROFILE_FITNESS );
+
+    if ( table.length() < max_fitness( max_phenotype, distance ) + 1 ){
+        stop( "The weight table is too short for 'max_phenotype'." );
+    }
+    if ( target < 0 || target > max_phenotype ){
+        stop( "'target' must be in [0, max_phenotype]." );
+    }
+    check_weight_table( table );
+
+    int n = phenotypes.length();
+    IntegerVector fitness( n );
+    NumericVector weights( n );
+
+    const int* p = INTEGER(phenotypes);
+    for ( int i = 0; i < n; i ++ ){
+        if ( p[i] < 0 || p[i] > max_phenotype ){
+            stop( "Phenotype at position %d is outside [0, max_phenotype].", i + 1 );
+        }
+    }
+
+    table_weight weight( REAL(table) );
+    if ( distance == DISTANCE_WRAPPED ){
+        fitness_weights( p, n, target, wrapped_distance( max_phenotype ), weight, INTEGER(fitness), REAL(weights) );
+    } else {
+        fitness_weights( p, n, target, unwrapped_distance( max_phenotype ), weight, INTEGER(fitness), REAL(weights) );
+    }
+
+    return( List::create( Named("fitness") = fitness, Named("weights") = weights ) );
+}
+
+// Fathers and mothers in two columns, indexed from 0 as in mcdowell_sampling
+// [[Rcpp::export]]
+IntegerMatrix CAB_cpp_EBD_histogram_selection( IntegerVector fitness, NumericVector table, int n_pairs, bool by_organism ){
+
+    CAB_PROFILE_SCOPE( PROFILE_SELECTION );
+
+    int n = fitness.length();
+    check_fitness_range( INTEGER(fitness), n, table.length() );
+    check_weight_table( table );
+
+    fitness_histogram histogram;
+    build_fitness_histogram( INTEGER(fitness), n, REAL(table), table.length(), by_organism, histogram );
+
+    IntegerMatrix parents( n_pairs, 2 );
+    xoshiro256 rng( seed_from_uniforms( R::unif_rand(), R::unif_rand() ) );
+    if ( !sample_parents( rng, histogram, n_pairs, INTEGER(parents), INTEGER(parents) + n_pairs ) ){
+        stop( "Need at least two organisms with positive weights to select parents." );
+    }
+
+    return( parents );
+}
@@ -0,0 +1,151 @@
+#ifndef EBD_FITNESS_H
+#define EBD_FITNESS_H
+
+#include <cmath>
+#include <cstdlib>
+
+// Fitness and fitness weights for EBD as policy classes.
+// A distance policy gives the fitness of a phenotype from its distance to the reinforced response and
+// a weight policy turns fitness into a parental selection weight. fitness_weights() fuses both into one
+// loop over the population that writes into buffers owned by the caller. The policies are template
+// parameters, so new ones are inlined into the loop without virtual calls.
+//
+// A distance policy has  int operator()( int phenotype, int target ) const
+// A weight policy has    double operator()( int fitness ) const  and  static const bool computes
+
+// As EBD_WSI_fitness: distances more than half way around [0, max_phenotype] are wrapped
+struct wrapped_distance {
+    int maximum;
+    int half;
+    explicit wrapped_distance( int max_phenotype ) : maximum( max_phenotype + 1 ), half( ( max_phenotype + 1 ) / 2 ) {}
+    inline int operator()( int phenotype, int target ) const {
+        int d = std::abs( phenotype - target );
+        return( d > half ? maximum - d : d );
+    }
+};
+
+struct unwrapped_distance {
+    explicit unwrapped_distance( int ) {}
+    inline int operator()( int phenotype, int target ) const {
+        return( std::abs( phenotype - target ) );
+    }
+};
+
+// As dgeom( fitness, p ), for p in (0, 1]. With p = 1, log( 1 - p ) is -Inf and all the weight is on fitness 0.
+struct geometric_weight {
+    static const bool computes = true;
+    double log_p;
+    double log_q;
+    bool certain;
+    explicit geometric_weight( double p ) : log_p( std::log(p) ), log_q( std::log1p( -p ) ), certain( p == 1 ) {}
+    inline double operator()( int fitness ) const {
+        if ( certain ) return( fitness == 0 ? 1 : 0 );
+        return( std::exp( log_p + fitness * log_q ) );
+    }
+};
+
+// As dexp( fitness, 1 / mean )
+struct exponential_weight {
+    static const bool computes = true;
+    double rate;
+    explicit exponential_weight( double mean ) : rate( 1 / mean ) {}
+    inline double operator()( int fitness ) const {
+        return( rate * std::exp( -rate * fitness ) );
+    }
+};
+
+// McDowell's linear density, which falls from its peak at 0 to 0 at 3 * mean
+struct linear_weight {
+    static const bool computes = true;
+    double upper;
+    explicit linear_weight( double mean ) : upper( 3 * mean ) {}
+    inline double operator()( int fitness ) const {
+        return( fitness >= upper ? 0 : 2 / upper * ( 1 - fitness / upper ) );
+    }
+};
+
+// Fitness only
+struct no_weight {
+    static const bool computes = false;
+    explicit no_weight( double ) {}
+    inline double operator()( int ) const {
+        return( 0 );
+    }
+};
+
+// Weights looked up by fitness from a table made by fill_weight_table()
+struct table_weight {
+    static const bool computes = true;
+    const double* table;
+    explicit table_weight( const double* table ) : table( table ) {}
+    inline double operator()( int fitness ) const {
+        return( table[fitness] );
+    }
+};
+
+template <typename Distance, typename Weight>
+inline void fitness_weights( const int* phenotypes, int n, int target, const Distance& distance, const Weight& weight, int* fitness, double* weights ){
+    for ( int i = 0; i < n; i ++ ){
+        int f = distance( phenotypes[i], target );
+        fitness[i] = f;
+        if ( Weight::computes ){
+            weights[i] = weight( f );
+        }
+    }
+}
+
+enum fitness_distance { DISTANCE_WRAPPED, DISTANCE_UNWRAPPED };
+enum fitness_weight { WEIGHT_GEOMETRIC, WEIGHT_EXPONENTIAL, WEIGHT_LINEAR, WEIGHT_NONE };
+
+template <typename Distance>
+inline void fitness_weights_dispatch_weight( const int* phenotypes, int n, int target, const Distance& distance, int weight, double parameter, int* fitness, double* weights ){
+    switch( weight ){
+        case WEIGHT_GEOMETRIC:
+            fitness_weights( phenotypes, n, target, distance, geometric_weight( parameter ), fitness, weights );
+            break;
+        case WEIGHT_EXPONENTIAL:
+            fitness_weights( phenotypes, n, target, distance, exponential_weight( parameter ), fitness, weights );
+            break;
+        case WEIGHT_LINEAR:
+            fitness_weights( phenotypes, n, target, distance, linear_weight( parameter ), fitness, weights );
+            break;
+        default:
+            fitness_weights( phenotypes, n, target, distance, no_weight( parameter ), fitness, weights );
+    }
+}
+
+// Picks the instantiation once per call, outside the loop over the population
+inline void fitness_weights_dispatch( const int* phenotypes, int n, int target, int max_phenotype, int distance, int weight, double parameter, int* fitness, double* weights ){
+    if ( distance == DISTANCE_WRAPPED ){
+        fitness_weights_dispatch_weight( phenotypes, n, target, wrapped_distance( max_phenotype ), weight, parameter, fitness, weights );
+    } else {
+        fitness_weights_dispatch_weight( phenotypes, n, target, unwrapped_distance( max_phenotype ), weight, parameter, fitness, weights );
+    }
+}
+
+// Largest fitness a distance can give, so weight tables need max_fitness() + 1 entries
+inline int max_fitness( int max_phenotype, int distance ){
+    return( distance == DISTANCE_WRAPPED ? ( max_phenotype + 1 ) / 2 : max_phenotype );
+}
+
+template <typename Weight>
+inline void fill_weight_table( const Weight& weight, int n, double* table ){
+    for ( int f = 0; f < n; f ++ ){
+        table[f] = weight(f);
+    }
+}
+
+inline void fill_weight_table_dispatch( int weight, double parameter, int n, double* table ){
+    switch( weight ){
+        case WEIGHT_GEOMETRIC:
+            fill_weight_table( geometric_weight( parameter ), n, table );
+            break;
+        case WEIGHT_EXPONENTIAL:
+            fill_weight_table( exponential_weight( parameter ), n, table );
+            break;
+        default:
+            fill_weight_table( linear_weight( parameter ), n, table );
+    }
+}
+
+#endif
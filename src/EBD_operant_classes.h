@@ -0,0 +1,69 @@
+#ifndef EBD_OPERANT_CLASSES_H
+#define EBD_OPERANT_CLASSES_H
+
+#include <vector>
+#include <algorithm>
+
+// The operant classes of a population, kept up to date one organism at a time.
+// Class c holds the phenotypes from lower[c] to lower[c+1] - 1, as in EBD_prp_race, with lower[0] = 0.
+// Each class has a list of its members, and each organism knows its position in the list of its class,
+// so moving an organism to another class is a swap with the last member and a push: O(1) after the
+// O( log n_classes ) classification. The counts of the classes are the sizes of the lists.
+
+class operant_class_index {
+public:
+    std::vector<int> lower;
+    std::vector< std::vector<int> > members;
+    std::vector<int> class_of;      // class of each organism
+    std::vector<int> position;      // position of each organism in the members of its class
+
+    void set_classes( const std::vector<int>& lower_bounds ){
+        lower = lower_bounds;
+        members.assign( lower.size(), std::vector<int>() );
+    }
+
+    int n_classes() const {
+        return( lower.size() );
+    }
+
+    int count( int c ) const {
+        return( members[c].size() );
+    }
+
+    int classify( int phenotype ) const {
+        return( std::upper_bound( lower.begin(), lower.end(), phenotype ) - lower.begin() - 1 );
+    }
+
+    // From scratch, O( n log n_classes ). Members are listed in organism order.
+    void build( const std::vector<int>& phenotypes ){
+        int n = phenotypes.size();
+        class_of.resize( n );
+        position.resize( n );
+        for ( size_t c = 0; c < members.size(); c ++ ) members[c].clear();
+        for ( int i = 0; i < n; i ++ ){
+            int c = classify( phenotypes[i] );
+            class_of[i] = c;
+            position[i] = members[c].size();
+            members[c].push_back( i );
+        }
+    }
+
+    // The organism now has phenotype
+    void update( int organism, int phenotype ){
+        int c = classify( phenotype );
+        int old = class_of[ organism ];
+        if ( c == old ) return;
+
+        std::vector<int>& from = members[ old ];
+        int moved = from.back();
+        from[ position[ organism ] ] = moved;
+        position[ moved ] = position[ organism ];
+        from.pop_back();
+
+        position[ organism ] = members[c].size();
+        members[c].push_back( organism );
+        class_of[ organism ] = c;
+    }
+};
+
+#endif
@@ -1,6 +1,9 @@
 // [[Rcpp::depends(RcppArmadillo)]]
 
 #include <RcppArmadillo.h>
+#include <limits>
+#include "CAB_cpp_profile.h"
+#include "CAB_cpp_arena.h"
 using namespace Rcpp;
 
 //'@export EBD_prp_race
@@ -8,46 +11,64 @@ using namespace Rcpp;
 // [[Rcpp::export]]
 List EBD_prp_race( arma::uvec phenotypes, arma::uvec oc_lower, int prp_size ){
 
+    CAB_PROFILE_SCOPE( PROFILE_EMISSION );
+
     int n_phenotypes = phenotypes.size();
     int n_oc = oc_lower.size();
 
-    arma::fvec class_probs( n_oc, arma::fill::zeros );
-    arma::uvec operant_classes( n_phenotypes );
-    int oc = 0;
+    // Every phenotype must fall in a class
+    bool increasing = n_oc > 0 && oc_lower[0] == 0;
+    for ( int j = 1; j < n_oc && increasing; j ++ ){
+        increasing = oc_lower[j] > oc_lower[j-1];
+    }
+    if ( !increasing ){
+        stop( "'oc_lower' must be increasing from 0." );
+    }
+
+    // Working memory is scratch, so an emission allocates nothing but its result
+    scratch_scope scope;
+    scratch_vector<int> class_counts( n_oc, 0 );
+    scratch_vector<int> operant_classes( n_phenotypes );
 
     for ( int i = 0; i < n_phenotypes; i ++ ){
-        oc = sum( phenotypes[i] >= oc_lower ) - 1;
-        class_probs( oc ) += 1;
-        operant_classes(i) = oc;
+        int oc = -1;
+        for ( int j = 0; j < n_oc; j ++ ){
+            oc += phenotypes[i] >= oc_lower[j];
+        }
+        class_counts[ oc ] ++;
+        operant_classes[i] = oc;
     }
 
-    class_probs = class_probs / phenotypes.size();
-
-    arma::fvec prp( n_oc );
-    prp.fill( arma::datum::inf );
+    scratch_vector<float> prp( n_oc, std::numeric_limits<float>::infinity() );
+    float fastest = std::numeric_limits<float>::infinity();
     for ( int i = 0; i < n_oc; i ++ ){
-        if ( class_probs(i) > 0 ){
-            prp(i) = R::rnbinom( prp_size, class_probs(i) );
+        float class_prob = (float) class_counts[i] / (float) n_phenotypes;
+        if ( class_prob > 0 ){
+            prp[i] = R::rnbinom( prp_size, class_prob );
         }
+        fastest = std::min( fastest, prp[i] );
     }
+    int fastest_prp = fastest;
 
-    int fastest_class = -1;
-    int fastest_prp = min( prp );
-
-    arma::uvec winning_classes = find( abs( prp- fastest_prp ) < 0.0000000001 );
-    fastest_class = winning_classes(0);
-
-    if ( winning_classes.size() > 0 ){
-        for ( int i = 0; i < winning_classes.size(); i ++ ){
-            operant_classes( find( operant_classes ) == winning_classes(i) ).fill( fastest_class );
+    // Classes that tie for the fastest PRP are pooled
+    scratch_vector<int> winning( n_oc, 0 );
+    int n_responses = 0;
+    for ( int i = 0; i < n_oc; i ++ ){
+        if ( std::fabs( prp[i] - fastest_prp ) < 0.0000000001 ){
+            winning[i] = 1;
+            n_responses += class_counts[i];
         }
     }
 
-   int response = -1;
-   arma::uvec responses_in_oc = phenotypes( find( operant_classes == fastest_class ) );
-   int response_index = sample( responses_in_oc.size(), 1, true)(0);
-   // Subtract 1 because sample samples from [1:n]
-   response = responses_in_oc( response_index-1 );
+    scratch_vector<int> responses_in_oc;
+    responses_in_oc.reserve( n_responses );
+    for ( int i = 0; i < n_phenotypes; i ++ ){
+        if ( winning[ operant_classes[i] ] ) responses_in_oc.push_back( phenotypes[i] );
+    }
+
+    int response_index = sample( (int) responses_in_oc.size(), 1, true )(0);
+    // Subtract 1 because sample samples from [1:n]
+    int response = responses_in_oc[ response_index - 1 ];
 
     List return_list = List::create( Named("response") = response, Named("time") = fastest_prp );
     return( return_list );
@@ -0,0 +1,199 @@
+#include <Rcpp.h>
+#include <vector>
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include "EBD_engine_R.h"
+#include "CAB_cpp_statistics.h"
+#include "CAB_cpp_arena.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+using namespace Rcpp;
+
+// Racing of parameter points by the loss of replicate EBD sessions.
+// Points are raced one after another against the best point so far (the incumbent). Replicates of a point
+// are run in batches across threads and the running mean and confidence interval of its loss are updated
+// after each batch. A point is dropped once the lower bound of its loss is above the upper bound of the
+// incumbent's. Every replicate has its own RNG stream, so results do not depend on the number of threads.
+// The engine's profile counters are atomic, so replicates can run with profiling on.
+
+enum race_loss { LOSS_KS_IRT, LOSS_RESPONSE_RATE };
+
+// A replicate is checked this many times for cutting it short
+static const int RACE_CHECKS = 16;
+
+struct race_settings {
+    int pop_size;
+    long long ticks;
+    int loss;
+    std::vector<double> observed;   // sorted observed IRTs for LOSS_KS_IRT
+    double target_rate;             // responses per tick for LOSS_RESPONSE_RATE
+    double threshold;               // replicates are cut short once their loss must exceed this
+    bool skip;
+};
+
+static int count_responses( const ebd_record& record, size_t from ){
+    int count = 0;
+    for ( size_t i = from; i < record.event.size(); i ++ ){
+        if ( record.event[i] == 0 ) count ++;
+    }
+    return( count );
+}
+
+// Distance from target to [lower, upper]
+static inline double distance_to_range( double target, double lower, double upper ){
+    return( target < lower ? lower - target : target > upper ? target - upper : 0 );
+}
+
+// Loss of one replicate. cut is set when the replicate was cut short, and the loss is then only known to
+// exceed the threshold.
+static double replicate_loss( const ebd_parameters& p, const ebd_pipeline& pipeline, const schedule_set& schedules, const race_settings& settings, uint64_t seed, bool& cut ){
+
+    xoshiro256 rng( seed );
+    std::vector<int> phenotypes( settings.pop_size );
+    for ( int i = 0; i < settings.pop_size; i ++ ){
+        phenotypes[i] = rng.bounded( 1u << p.n_bits );
+    }
+
+    ebd_engine engine( p, schedules, rng.next(), phenotypes, pipeline );
+    engine.start();
+    ebd_record record;
+    cut = false;
+    double ticks = (double) settings.ticks;
+
+    if ( settings.loss == LOSS_RESPONSE_RATE ){
+        int responses = 0;
+        bool checks = settings.threshold < std::numeric_limits<double>::infinity();
+        for ( int c = 1; c <= ( checks ? RACE_CHECKS : 1 ); c ++ ){
+            size_t from = record.event.size();
+            engine.run( checks ? settings.ticks * c / RACE_CHECKS : settings.ticks, INT_MAX, settings.skip, record );
+            responses += count_responses( record, from );
+            // At most one response per tick, so the final rate lies in [lower, upper]
+            double lower = responses / ticks;
+            double upper = ( responses + (double) ( settings.ticks - engine.tick ) ) / ticks;
+            double bound = distance_to_range( settings.target_rate, lower, upper );
+            if ( bound > settings.threshold ){
+                cut = true;
+                return( bound );
+            }
+        }
+        return( std::fabs( responses / ticks - settings.target_rate ) );
+    }
+
+    engine.run( settings.ticks, INT_MAX, settings.skip, record );
+    scratch_scope scope;
+    scratch_vector<double> irts;
+    irts.reserve( record.event.size() );
+    double last = -1;
+    for ( size_t i = 0; i < record.event.size(); i ++ ){
+        if ( record.event[i] != 0 ) continue;
+        if ( last >= 0 ) irts.push_back( record.time[i] - last );
+        last = record.time[i];
+    }
+    if ( irts.empty() ) return( 1 );
+    std::sort( irts.begin(), irts.end() );
+    return( ks_sorted( &irts[0], irts.size(), &settings.observed[0], settings.observed.size() ) );
+}
+
+// loss: 0 = KS between simulated and observed IRTs on the first alternative, 1 = absolute error of the response rate
+// [[Rcpp::export]]
+List CAB_cpp_EBD_race( List points, List components, List schedule, int pop_size, double ticks, int loss, NumericVector observed, double target_rate,
+    int min_replicates, int max_replicates, int batch, double z, double threshold, bool skip ){
+
+    int n_points = points.length();
+    std::vector<ebd_parameters> parameters;
+    for ( int i = 0; i < n_points; i ++ ){
+        parameters.push_back( ebd_parameters_from_list( points[i] ) );
+    }
+    schedule_set schedules = schedule_set_from_list( schedule );
+    ebd_r_stages r;
+    ebd_pipeline pipeline = ebd_pipeline_from_list( components, r, false );
+
+    if ( pop_size < 2 ) stop( "The population needs at least two organisms." );
+    if ( !( ticks >= 1 ) ) stop( "'ticks' must be at least 1." );
+    if ( min_replicates < 2 || max_replicates < min_replicates || batch < 1 ){
+        stop( "Need 2 <= 'min_replicates' <= 'max_replicates' and a positive 'batch'." );
+    }
+
+    race_settings settings;
+    settings.pop_size = pop_size;
+    settings.ticks = (long long) ticks;
+    settings.loss = loss;
+    settings.observed.assign( observed.begin(), observed.end() );
+    std::sort( settings.observed.begin(), settings.observed.end() );
+    settings.target_rate = target_rate;
+    settings.threshold = threshold;
+    settings.skip = skip;
+    if ( loss == LOSS_KS_IRT && settings.observed.empty() ){
+        stop( "'observed' must not be empty for the KS loss." );
+    }
+
+    uint64_t seed = seed_from_uniforms( R::unif_rand(), R::unif_rand() );
+
+    NumericVector mean( n_points ), lower( n_points ), upper( n_points );
+    IntegerVector replicates( n_points ), cut( n_points );
+    LogicalVector dropped( n_points );
+    int incumbent = -1;
+    double incumbent_mean = std::numeric_limits<double>::infinity();
+    double incumbent_upper = std::numeric_limits<double>::infinity();
+
+    std::vector<double> losses( max_replicates );
+    std::vector<int> cuts( max_replicates );
+
+    for ( int point = 0; point < n_points; point ++ ){
+        // Cut replicates are censored: their loss is above the threshold but otherwise unknown, so they
+        // are added to the statistics at the threshold. The mean is then a lower bound on the mean loss,
+        // which keeps the test for dropping the point conservative.
+        running_statistics statistics;
+        int n_cut = 0;
+        bool drop = false;
+
+        while ( statistics.n < max_replicates ){
+            int first = statistics.n;
+            int size = std::min( max_replicates - first, std::max( batch, min_replicates - first ) );
+
+            #pragma omp parallel for schedule(dynamic)
+            for ( int r = first; r < first + size; r ++ ){
+                bool replicate_cut;
+                losses[r] = replicate_loss( parameters[point], pipeline, schedules, settings, stream_seed( seed, (uint64_t) point * max_replicates + r ), replicate_cut );
+                cuts[r] = replicate_cut;
+            }
+
+            for ( int r = first; r < first + size; r ++ ){
+                n_cut += cuts[r];
+                statistics.add( cuts[r] ? settings.threshold : losses[r] );
+            }
+
+            if ( statistics.n >= min_replicates && incumbent >= 0 &&
+                statistics.mean - statistics.half_width( z ) > incumbent_upper ){
+                drop = true;
+                break;
+            }
+        }
+
+        double half = statistics.half_width( z );
+        mean[point] = statistics.mean;
+        lower[point] = statistics.mean - half;
+        upper[point] = statistics.mean + half;
+        replicates[point] = statistics.n;
+        cut[point] = n_cut;
+        dropped[point] = drop;
+
+        if ( !drop && statistics.mean < incumbent_mean ){
+            incumbent = point;
+            incumbent_mean = statistics.mean;
+            incumbent_upper = statistics.mean + half;
+        }
+        Rcpp::checkUserInterrupt();
+    }
+
+    return( List::create(
+        Named("mean") = mean,
+        Named("lower") = lower,
+        Named("upper") = upper,
+        Named("replicates") = replicates,
+        Named("cut") = cut,
+        Named("dropped") = dropped,
+        Named("incumbent") = incumbent < 0 ? NA_INTEGER : incumbent + 1 ) );
+}
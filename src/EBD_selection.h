@@ -0,0 +1,68 @@
+#ifndef EBD_SELECTION_H
+#define EBD_SELECTION_H
+
+#include <vector>
+#include <algorithm>
+#include "CAB_cpp_event_record.h"
+#include "CAB_cpp_rng.h"
+
+// Parental selection from a histogram of the population over fitness.
+// Fitness takes at most max_fitness() + 1 values, so the population is bucketed by fitness with a
+// counting sort, a bucket is sampled by its weight, and then a member of the bucket is sampled
+// uniformly. Each draw is a binary search over the buckets instead of a pass over the population.
+
+struct fitness_histogram {
+    label_index members;        // organisms in each fitness bucket
+    std::vector<double> cumulative;   // cumulative bucket weights
+    std::vector<int> buckets;   // fitness of each bucket in cumulative
+};
+
+// by_organism: bucket weights are weight * count, so every organism is chosen with probability proportional
+// to its weight. Otherwise every fitness present in the population has its weight once, as in mcdowell_sampling.
+inline void build_fitness_histogram( const int* fitness, int n, const double* weight_table, int n_fitness, bool by_organism, fitness_histogram& histogram ){
+
+    build_label_index( fitness, n, n_fitness, histogram.members );
+
+    histogram.cumulative.clear();
+    histogram.buckets.clear();
+    double total = 0;
+    for ( int f = 0; f < n_fitness; f ++ ){
+        int count = histogram.members.offsets[f+1] - histogram.members.offsets[f];
+        if ( count == 0 || weight_table[f] <= 0 ) continue;
+        total += by_organism ? weight_table[f] * count : weight_table[f];
+        histogram.cumulative.push_back( total );
+        histogram.buckets.push_back( f );
+    }
+}
+
+// One organism, or -1 if no organism has a positive weight
+inline int sample_fitness_histogram( xoshiro256& rng, const fitness_histogram& histogram ){
+    if ( histogram.cumulative.empty() ) return( -1 );
+    double u = rng.uniform() * histogram.cumulative.back();
+    int b = std::upper_bound( histogram.cumulative.begin(), histogram.cumulative.end(), u ) - histogram.cumulative.begin();
+    if ( b >= (int) histogram.buckets.size() ) b = histogram.buckets.size() - 1;
+    int f = histogram.buckets[b];
+    int first = histogram.members.offsets[f];
+    int count = histogram.members.offsets[f+1] - first;
+    return( histogram.members.rows[ first + rng.bounded( count ) ] );
+}
+
+// Fathers and mothers for n_pairs children. Mothers are redrawn until they differ from the father,
+// which gives the distribution of the mother conditional on the father.
+inline bool sample_parents( xoshiro256& rng, const fitness_histogram& histogram, int n_pairs, int* fathers, int* mothers ){
+    if ( histogram.members.rows.size() < 2 || histogram.cumulative.empty() ) return( false );
+    // With one positive bucket of one organism, no mother differs from the father
+    if ( histogram.buckets.size() == 1 ){
+        int f = histogram.buckets[0];
+        if ( histogram.members.offsets[f+1] - histogram.members.offsets[f] < 2 ) return( false );
+    }
+    for ( int i = 0; i < n_pairs; i ++ ){
+        fathers[i] = sample_fitness_histogram( rng, histogram );
+        do {
+            mothers[i] = sample_fitness_histogram( rng, histogram );
+        } while ( mothers[i] == fathers[i] );
+    }
+    return( true );
+}
+
+#endif
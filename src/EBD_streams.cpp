@@ -0,0 +1,120 @@
+#include <Rcpp.h>
+#include <cmath>
+#include <vector>
+#include "CAB_cpp_rng.h"
+using namespace Rcpp;
+
+// Random streams for the emission and mutation stages of EBD models built with CAB.model.
+// A stream is made once per organism and kept in the model as an external pointer. It draws what a tick
+// needs from blocks that are refilled on demand, instead of from vectors made for the whole session.
+
+typedef block_stream< uint32_t, bounded_draw > index_stream;
+
+// The organisms of a tick are a partial Fisher-Yates shuffle, so they are distinct without redraws
+struct gaussian_mutation_stream {
+    xoshiro256 organisms;
+    std::vector<int> permutation;
+    std::vector<int> mutant_index;
+    block_stream< double, normal_draw > changes;
+    int pop_size;
+    int n_mutants;
+    double sd;
+
+    gaussian_mutation_stream( uint64_t seed, int pop_size, int n_mutants, double sd, int block_size ) :
+        organisms( stream_seed( seed, 0 ) ), mutant_index( n_mutants ),
+        changes( stream_seed( seed, 1 ), normal_draw(), block_size ),
+        pop_size( pop_size ), n_mutants( n_mutants ), sd( sd ) {}
+};
+
+// Streams are tagged with the kind of stream, and the tag is checked before the pointer is used.
+// A stream that was saved and loaded again has a NULL address.
+static const char* EMISSION_STREAM = "CAB_emission_stream";
+static const char* GAUSSIAN_MUTATION_STREAM = "CAB_gaussian_mutation_stream";
+
+template <typename T>
+static XPtr<T> stream_pointer( SEXP stream, const char* tag ){
+    if ( TYPEOF( stream ) != EXTPTRSXP || R_ExternalPtrTag( stream ) != Rf_install( tag ) ){
+        stop( "'stream' is not a %s.", tag );
+    }
+    if ( R_ExternalPtrAddr( stream ) == NULL ){
+        stop( "'stream' is no longer valid. Streams cannot be saved and loaded." );
+    }
+    return( XPtr<T>( stream ) );
+}
+
+// Phenotypes come as integer or double vectors, and are read in place instead of being copied
+static R_xlen_t phenotype_length( SEXP phenotypes ){
+    if ( TYPEOF( phenotypes ) != INTSXP && TYPEOF( phenotypes ) != REALSXP ){
+        stop( "'phenotypes' must be a numeric vector." );
+    }
+    return( Rf_xlength( phenotypes ) );
+}
+
+static double phenotype_at( SEXP phenotypes, R_xlen_t i ){
+    if ( TYPEOF( phenotypes ) == REALSXP ) return( REAL( phenotypes )[i] );
+    int phenotype = INTEGER( phenotypes )[i];
+    return( phenotype == NA_INTEGER ? NA_REAL : (double) phenotype );
+}
+
+static uint64_t seed_from_r(){
+    return( seed_from_uniforms( R::unif_rand(), R::unif_rand() ) );
+}
+
+// [[Rcpp::export]]
+SEXP CAB_cpp_emission_stream( int pop_size, int block_size ){
+    if ( pop_size < 1 ) stop( "'pop_size' must be at least 1." );
+    XPtr< index_stream > stream( new index_stream( seed_from_r(), bounded_draw( pop_size ), block_size ), true, Rf_install( EMISSION_STREAM ), R_NilValue );
+    return( stream );
+}
+
+// Returns the emitted phenotype with the type of phenotypes
+// [[Rcpp::export]]
+SEXP CAB_cpp_stream_emission( SEXP stream, SEXP phenotypes ){
+    XPtr< index_stream > emission = stream_pointer< index_stream >( stream, EMISSION_STREAM );
+    if ( (R_xlen_t) emission->draw.n != phenotype_length( phenotypes ) ){
+        stop( "The stream was made for a population of %d.", (int) emission->draw.n );
+    }
+    uint32_t organism = emission->next();
+    if ( TYPEOF( phenotypes ) == INTSXP ) return( Rf_ScalarInteger( INTEGER( phenotypes )[ organism ] ) );
+    return( Rf_ScalarReal( REAL( phenotypes )[ organism ] ) );
+}
+
+// [[Rcpp::export]]
+SEXP CAB_cpp_gaussian_mutation_stream( int pop_size, int n_mutants, double sd, int block_size ){
+    if ( n_mutants < 0 || n_mutants > pop_size ) stop( "'n_mutants' must be between 0 and 'pop_size'." );
+    if ( !R_finite( sd ) || sd < 0 ) stop( "'sd' must be a non-negative number." );
+    XPtr< gaussian_mutation_stream > stream( new gaussian_mutation_stream( seed_from_r(), pop_size, n_mutants, sd, block_size ), true,
+        Rf_install( GAUSSIAN_MUTATION_STREAM ), R_NilValue );
+    return( stream );
+}
+
+// Mutants are distinct organisms. Indices count from 1.
+// [[Rcpp::export]]
+List CAB_cpp_stream_gaussian_mutation( SEXP stream, int max_phenotype, SEXP phenotypes ){
+    XPtr< gaussian_mutation_stream > mutation = stream_pointer< gaussian_mutation_stream >( stream, GAUSSIAN_MUTATION_STREAM );
+    int n = mutation->n_mutants;
+    if ( (R_xlen_t) mutation->pop_size != phenotype_length( phenotypes ) ){
+        stop( "The stream was made for a population of %d.", mutation->pop_size );
+    }
+    if ( max_phenotype == NA_INTEGER || max_phenotype < 0 ){
+        stop( "'max_phenotype' must not be negative." );
+    }
+
+    if ( n > 0 ){
+        partial_fisher_yates( mutation->organisms, mutation->permutation, mutation->pop_size, n, &mutation->mutant_index[0] );
+    }
+    IntegerVector mutants( n ), mutant_index( n );
+    int range = max_phenotype + 1;
+    for ( int i = 0; i < n; i ++ ){
+        int organism = mutation->mutant_index[i];
+        double phenotype = phenotype_at( phenotypes, organism );
+        if ( !R_finite( phenotype ) ){
+            stop( "Phenotype at position %d is missing.", organism + 1 );
+        }
+        int change = (int) std::floor( mutation->sd * mutation->changes.next() + 0.5 );
+        int mutant = ( (int) phenotype + change ) % range;
+        mutant_index[i] = organism + 1;
+        mutants[i] = mutant < 0 ? mutant + range : mutant;
+    }
+    return( List::create( Named("mutants") = mutants, Named("mutant_index") = mutant_index ) );
+}
@@ -29,6 +29,22 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// CAB_cpp_bouts
+List CAB_cpp_bouts(DataFrame data, CharacterVector labels, CharacterVector break_events, double gap, double session_duration, NumericVector length_breaks);
+RcppExport SEXP _CAB_CAB_cpp_bouts(SEXP dataSEXP, SEXP labelsSEXP, SEXP break_eventsSEXP, SEXP gapSEXP, SEXP session_durationSEXP, SEXP length_breaksSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< DataFrame >::type data(dataSEXP);
+    Rcpp::traits::input_parameter< CharacterVector >::type labels(labelsSEXP);
+    Rcpp::traits::input_parameter< CharacterVector >::type break_events(break_eventsSEXP);
+    Rcpp::traits::input_parameter< double >::type gap(gapSEXP);
+    Rcpp::traits::input_parameter< double >::type session_duration(session_durationSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type length_breaks(length_breaksSEXP);
+    rcpp_result_gen = Rcpp::wrap(CAB_cpp_bouts(data, labels, break_events, gap, session_duration, length_breaks));
+    return rcpp_result_gen;
+END_RCPP
+}
 // CAB_cpp_clean_short_ixyi
 LogicalVector CAB_cpp_clean_short_ixyi(DataFrame data, String x_name, String y_name, double gap);
 RcppExport SEXP _CAB_CAB_cpp_clean_short_ixyi(SEXP dataSEXP, SEXP x_nameSEXP, SEXP y_nameSEXP, SEXP gapSEXP) {
@@ -70,6 +86,31 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// CAB_cpp_formal_to_ragged
+List CAB_cpp_formal_to_ragged(DataFrame data, CharacterVector variables);
+RcppExport SEXP _CAB_CAB_cpp_formal_to_ragged(SEXP dataSEXP, SEXP variablesSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< DataFrame >::type data(dataSEXP);
+    Rcpp::traits::input_parameter< CharacterVector >::type variables(variablesSEXP);
+    rcpp_result_gen = Rcpp::wrap(CAB_cpp_formal_to_ragged(data, variables));
+    return rcpp_result_gen;
+END_RCPP
+}
+// CAB_cpp_ragged_to_formal
+List CAB_cpp_ragged_to_formal(List event_times, IntegerVector counts, CharacterVector variables);
+RcppExport SEXP _CAB_CAB_cpp_ragged_to_formal(SEXP event_timesSEXP, SEXP countsSEXP, SEXP variablesSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< List >::type event_times(event_timesSEXP);
+    Rcpp::traits::input_parameter< IntegerVector >::type counts(countsSEXP);
+    Rcpp::traits::input_parameter< CharacterVector >::type variables(variablesSEXP);
+    rcpp_result_gen = Rcpp::wrap(CAB_cpp_ragged_to_formal(event_times, counts, variables));
+    return rcpp_result_gen;
+END_RCPP
+}
 // CAB_cpp_diff
 NumericVector CAB_cpp_diff(NumericVector x);
 RcppExport SEXP _CAB_CAB_cpp_diff(SEXP xSEXP) {
@@ -81,6 +122,18 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// CAB_cpp_event_label_index
+List CAB_cpp_event_label_index(CharacterVector event, CharacterVector labels);
+RcppExport SEXP _CAB_CAB_cpp_event_label_index(SEXP eventSEXP, SEXP labelsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< CharacterVector >::type event(eventSEXP);
+    Rcpp::traits::input_parameter< CharacterVector >::type labels(labelsSEXP);
+    rcpp_result_gen = Rcpp::wrap(CAB_cpp_event_label_index(event, labels));
+    return rcpp_result_gen;
+END_RCPP
+}
 // CAB_cpp_geometric_fitness_selection
 List CAB_cpp_geometric_fitness_selection(NumericVector fitness, int pop_size, double p);
 RcppExport SEXP _CAB_CAB_cpp_geometric_fitness_selection(SEXP fitnessSEXP, SEXP pop_sizeSEXP, SEXP pSEXP) {
@@ -94,6 +147,17 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// CAB_cpp_hash
+String CAB_cpp_hash(SEXP x);
+RcppExport SEXP _CAB_CAB_cpp_hash(SEXP xSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type x(xSEXP);
+    rcpp_result_gen = Rcpp::wrap(CAB_cpp_hash(x));
+    return rcpp_result_gen;
+END_RCPP
+}
 // CAB_cpp_indicator_matrix
 NumericMatrix CAB_cpp_indicator_matrix(NumericVector x);
 RcppExport SEXP _CAB_CAB_cpp_indicator_matrix(SEXP xSEXP) {
@@ -106,14 +170,58 @@ BEGIN_RCPP
 END_RCPP
 }
 // CAB_cpp_int2bin
-IntegerVector CAB_cpp_int2bin(int bits, IntegerVector n);
-RcppExport SEXP _CAB_CAB_cpp_int2bin(SEXP bitsSEXP, SEXP nSEXP) {
+SEXP CAB_cpp_int2bin(int bits, NumericVector integers, int format);
+RcppExport SEXP _CAB_CAB_cpp_int2bin(SEXP bitsSEXP, SEXP integersSEXP, SEXP formatSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< int >::type bits(bitsSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type integers(integersSEXP);
+    Rcpp::traits::input_parameter< int >::type format(formatSEXP);
+    rcpp_result_gen = Rcpp::wrap(CAB_cpp_int2bin(bits, integers, format));
+    return rcpp_result_gen;
+END_RCPP
+}
+// CAB_cpp_bin2int
+IntegerVector CAB_cpp_bin2int(SEXP binaries, int bits);
+RcppExport SEXP _CAB_CAB_cpp_bin2int(SEXP binariesSEXP, SEXP bitsSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type binaries(binariesSEXP);
     Rcpp::traits::input_parameter< int >::type bits(bitsSEXP);
-    Rcpp::traits::input_parameter< IntegerVector >::type n(nSEXP);
-    rcpp_result_gen = Rcpp::wrap(CAB_cpp_int2bin(bits, n));
+    rcpp_result_gen = Rcpp::wrap(CAB_cpp_bin2int(binaries, bits));
+    return rcpp_result_gen;
+END_RCPP
+}
+// CAB_cpp_unpack_bit_planes
+IntegerVector CAB_cpp_unpack_bit_planes(IntegerMatrix planes, int n);
+RcppExport SEXP _CAB_CAB_cpp_unpack_bit_planes(SEXP planesSEXP, SEXP nSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< IntegerMatrix >::type planes(planesSEXP);
+    Rcpp::traits::input_parameter< int >::type n(nSEXP);
+    rcpp_result_gen = Rcpp::wrap(CAB_cpp_unpack_bit_planes(planes, n));
+    return rcpp_result_gen;
+END_RCPP
+}
+// CAB_cpp_irt_histograms
+NumericVector CAB_cpp_irt_histograms(List sessions, CharacterVector labels, CharacterVector break_events, IntegerVector groups, int n_groups, double lower, double upper, int bins_per_decade, double time_scale);
+RcppExport SEXP _CAB_CAB_cpp_irt_histograms(SEXP sessionsSEXP, SEXP labelsSEXP, SEXP break_eventsSEXP, SEXP groupsSEXP, SEXP n_groupsSEXP, SEXP lowerSEXP, SEXP upperSEXP, SEXP bins_per_decadeSEXP, SEXP time_scaleSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< List >::type sessions(sessionsSEXP);
+    Rcpp::traits::input_parameter< CharacterVector >::type labels(labelsSEXP);
+    Rcpp::traits::input_parameter< CharacterVector >::type break_events(break_eventsSEXP);
+    Rcpp::traits::input_parameter< IntegerVector >::type groups(groupsSEXP);
+    Rcpp::traits::input_parameter< int >::type n_groups(n_groupsSEXP);
+    Rcpp::traits::input_parameter< double >::type lower(lowerSEXP);
+    Rcpp::traits::input_parameter< double >::type upper(upperSEXP);
+    Rcpp::traits::input_parameter< int >::type bins_per_decade(bins_per_decadeSEXP);
+    Rcpp::traits::input_parameter< double >::type time_scale(time_scaleSEXP);
+    rcpp_result_gen = Rcpp::wrap(CAB_cpp_irt_histograms(sessions, labels, break_events, groups, n_groups, lower, upper, bins_per_decade, time_scale));
     return rcpp_result_gen;
 END_RCPP
 }
@@ -173,14 +281,49 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// compute_ixyi_indexed
+NumericVector compute_ixyi_indexed(SEXP times, CharacterVector labels, IntegerVector offsets, IntegerVector rows, CharacterVector x_event, CharacterVector y_event, CharacterVector break_events, double x_offset);
+RcppExport SEXP _CAB_compute_ixyi_indexed(SEXP timesSEXP, SEXP labelsSEXP, SEXP offsetsSEXP, SEXP rowsSEXP, SEXP x_eventSEXP, SEXP y_eventSEXP, SEXP break_eventsSEXP, SEXP x_offsetSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type times(timesSEXP);
+    Rcpp::traits::input_parameter< CharacterVector >::type labels(labelsSEXP);
+    Rcpp::traits::input_parameter< IntegerVector >::type offsets(offsetsSEXP);
+    Rcpp::traits::input_parameter< IntegerVector >::type rows(rowsSEXP);
+    Rcpp::traits::input_parameter< CharacterVector >::type x_event(x_eventSEXP);
+    Rcpp::traits::input_parameter< CharacterVector >::type y_event(y_eventSEXP);
+    Rcpp::traits::input_parameter< CharacterVector >::type break_events(break_eventsSEXP);
+    Rcpp::traits::input_parameter< double >::type x_offset(x_offsetSEXP);
+    rcpp_result_gen = Rcpp::wrap(compute_ixyi_indexed(times, labels, offsets, rows, x_event, y_event, break_events, x_offset));
+    return rcpp_result_gen;
+END_RCPP
+}
+// compute_ixxi_indexed
+NumericVector compute_ixxi_indexed(SEXP times, CharacterVector labels, IntegerVector offsets, IntegerVector rows, CharacterVector x_event, CharacterVector break_events, double x_offset);
+RcppExport SEXP _CAB_compute_ixxi_indexed(SEXP timesSEXP, SEXP labelsSEXP, SEXP offsetsSEXP, SEXP rowsSEXP, SEXP x_eventSEXP, SEXP break_eventsSEXP, SEXP x_offsetSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type times(timesSEXP);
+    Rcpp::traits::input_parameter< CharacterVector >::type labels(labelsSEXP);
+    Rcpp::traits::input_parameter< IntegerVector >::type offsets(offsetsSEXP);
+    Rcpp::traits::input_parameter< IntegerVector >::type rows(rowsSEXP);
+    Rcpp::traits::input_parameter< CharacterVector >::type x_event(x_eventSEXP);
+    Rcpp::traits::input_parameter< CharacterVector >::type break_events(break_eventsSEXP);
+    Rcpp::traits::input_parameter< double >::type x_offset(x_offsetSEXP);
+    rcpp_result_gen = Rcpp::wrap(compute_ixxi_indexed(times, labels, offsets, rows, x_event, break_events, x_offset));
+    return rcpp_result_gen;
+END_RCPP
+}
 // ks
-double ks(arma::colvec sample_1, arma::colvec sample_2);
+double ks(NumericVector sample_1, NumericVector sample_2);
 RcppExport SEXP _CAB_ks(SEXP sample_1SEXP, SEXP sample_2SEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
-    Rcpp::traits::input_parameter< arma::colvec >::type sample_1(sample_1SEXP);
-    Rcpp::traits::input_parameter< arma::colvec >::type sample_2(sample_2SEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type sample_1(sample_1SEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type sample_2(sample_2SEXP);
     rcpp_result_gen = Rcpp::wrap(ks(sample_1, sample_2));
     return rcpp_result_gen;
 END_RCPP
@@ -201,13 +344,13 @@ BEGIN_RCPP
 END_RCPP
 }
 // CAB_cpp_local_binning
-List CAB_cpp_local_binning(NumericVector local_times, NumericVector visit_lengths, int max_bin, double bin_resolution);
+List CAB_cpp_local_binning(SEXP local_times, SEXP visit_lengths, int max_bin, double bin_resolution);
 RcppExport SEXP _CAB_CAB_cpp_local_binning(SEXP local_timesSEXP, SEXP visit_lengthsSEXP, SEXP max_binSEXP, SEXP bin_resolutionSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
-    Rcpp::traits::input_parameter< NumericVector >::type local_times(local_timesSEXP);
-    Rcpp::traits::input_parameter< NumericVector >::type visit_lengths(visit_lengthsSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type local_times(local_timesSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type visit_lengths(visit_lengthsSEXP);
     Rcpp::traits::input_parameter< int >::type max_bin(max_binSEXP);
     Rcpp::traits::input_parameter< double >::type bin_resolution(bin_resolutionSEXP);
     rcpp_result_gen = Rcpp::wrap(CAB_cpp_local_binning(local_times, visit_lengths, max_bin, bin_resolution));
@@ -227,17 +370,133 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// CAB_cpp_profile_table
+DataFrame CAB_cpp_profile_table();
+RcppExport SEXP _CAB_CAB_cpp_profile_table() {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    rcpp_result_gen = Rcpp::wrap(CAB_cpp_profile_table());
+    return rcpp_result_gen;
+END_RCPP
+}
+// CAB_cpp_profile_reset
+bool CAB_cpp_profile_reset();
+RcppExport SEXP _CAB_CAB_cpp_profile_reset() {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    rcpp_result_gen = Rcpp::wrap(CAB_cpp_profile_reset());
+    return rcpp_result_gen;
+END_RCPP
+}
+// CAB_cpp_profile_enabled
+bool CAB_cpp_profile_enabled();
+RcppExport SEXP _CAB_CAB_cpp_profile_enabled() {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    rcpp_result_gen = Rcpp::wrap(CAB_cpp_profile_enabled());
+    return rcpp_result_gen;
+END_RCPP
+}
+// CAB_cpp_profile_add
+void CAB_cpp_profile_add(int stage, double seconds);
+RcppExport SEXP _CAB_CAB_cpp_profile_add(SEXP stageSEXP, SEXP secondsSEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< int >::type stage(stageSEXP);
+    Rcpp::traits::input_parameter< double >::type seconds(secondsSEXP);
+    CAB_cpp_profile_add(stage, seconds);
+    return R_NilValue;
+END_RCPP
+}
+// CAB_cpp_radix_sort
+SEXP CAB_cpp_radix_sort(SEXP x);
+RcppExport SEXP _CAB_CAB_cpp_radix_sort(SEXP xSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type x(xSEXP);
+    rcpp_result_gen = Rcpp::wrap(CAB_cpp_radix_sort(x));
+    return rcpp_result_gen;
+END_RCPP
+}
+// CAB_cpp_radix_order
+IntegerVector CAB_cpp_radix_order(SEXP x);
+RcppExport SEXP _CAB_CAB_cpp_radix_order(SEXP xSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type x(xSEXP);
+    rcpp_result_gen = Rcpp::wrap(CAB_cpp_radix_order(x));
+    return rcpp_result_gen;
+END_RCPP
+}
+// CAB_cpp_unique
+SEXP CAB_cpp_unique(SEXP x);
+RcppExport SEXP _CAB_CAB_cpp_unique(SEXP xSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type x(xSEXP);
+    rcpp_result_gen = Rcpp::wrap(CAB_cpp_unique(x));
+    return rcpp_result_gen;
+END_RCPP
+}
 // CAB_cpp_not_duplicated
-LogicalVector CAB_cpp_not_duplicated(NumericVector x);
+LogicalVector CAB_cpp_not_duplicated(SEXP x);
 RcppExport SEXP _CAB_CAB_cpp_not_duplicated(SEXP xSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
-    Rcpp::traits::input_parameter< NumericVector >::type x(xSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type x(xSEXP);
     rcpp_result_gen = Rcpp::wrap(CAB_cpp_not_duplicated(x));
     return rcpp_result_gen;
 END_RCPP
 }
+// CAB_cpp_radix_rle
+List CAB_cpp_radix_rle(SEXP x);
+RcppExport SEXP _CAB_CAB_cpp_radix_rle(SEXP xSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type x(xSEXP);
+    rcpp_result_gen = Rcpp::wrap(CAB_cpp_radix_rle(x));
+    return rcpp_result_gen;
+END_RCPP
+}
+// resample_indices
+IntegerMatrix resample_indices(int n, int repeats, int sample_size, bool replace);
+RcppExport SEXP _CAB_resample_indices(SEXP nSEXP, SEXP repeatsSEXP, SEXP sample_sizeSEXP, SEXP replaceSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< int >::type n(nSEXP);
+    Rcpp::traits::input_parameter< int >::type repeats(repeatsSEXP);
+    Rcpp::traits::input_parameter< int >::type sample_size(sample_sizeSEXP);
+    Rcpp::traits::input_parameter< bool >::type replace(replaceSEXP);
+    rcpp_result_gen = Rcpp::wrap(resample_indices(n, repeats, sample_size, replace));
+    return rcpp_result_gen;
+END_RCPP
+}
+// CAB_cpp_resample_statistic
+NumericVector CAB_cpp_resample_statistic(NumericVector x, int repeats, int sample_size, bool replace, int statistic, double probability, NumericVector reference);
+RcppExport SEXP _CAB_CAB_cpp_resample_statistic(SEXP xSEXP, SEXP repeatsSEXP, SEXP sample_sizeSEXP, SEXP replaceSEXP, SEXP statisticSEXP, SEXP probabilitySEXP, SEXP referenceSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< NumericVector >::type x(xSEXP);
+    Rcpp::traits::input_parameter< int >::type repeats(repeatsSEXP);
+    Rcpp::traits::input_parameter< int >::type sample_size(sample_sizeSEXP);
+    Rcpp::traits::input_parameter< bool >::type replace(replaceSEXP);
+    Rcpp::traits::input_parameter< int >::type statistic(statisticSEXP);
+    Rcpp::traits::input_parameter< double >::type probability(probabilitySEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type reference(referenceSEXP);
+    rcpp_result_gen = Rcpp::wrap(CAB_cpp_resample_statistic(x, repeats, sample_size, replace, statistic, probability, reference));
+    return rcpp_result_gen;
+END_RCPP
+}
 // mcdowell_sampling
 NumericMatrix mcdowell_sampling(NumericVector fitness, NumericVector fitness_weights);
 RcppExport SEXP _CAB_mcdowell_sampling(SEXP fitnessSEXP, SEXP fitness_weightsSEXP) {
@@ -276,14 +535,107 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
-// CAB_cpp_unique
-NumericVector CAB_cpp_unique(NumericVector x);
-RcppExport SEXP _CAB_CAB_cpp_unique(SEXP xSEXP) {
+// CAB_cpp_schedule_batch
+NumericVector CAB_cpp_schedule_batch(List schedule, int n);
+RcppExport SEXP _CAB_CAB_cpp_schedule_batch(SEXP scheduleSEXP, SEXP nSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
-    Rcpp::traits::input_parameter< NumericVector >::type x(xSEXP);
-    rcpp_result_gen = Rcpp::wrap(CAB_cpp_unique(x));
+    Rcpp::traits::input_parameter< List >::type schedule(scheduleSEXP);
+    Rcpp::traits::input_parameter< int >::type n(nSEXP);
+    rcpp_result_gen = Rcpp::wrap(CAB_cpp_schedule_batch(schedule, n));
+    return rcpp_result_gen;
+END_RCPP
+}
+// CAB_cpp_run_schedule
+List CAB_cpp_run_schedule(List schedule, NumericVector times, IntegerVector alternatives, double start);
+RcppExport SEXP _CAB_CAB_cpp_run_schedule(SEXP scheduleSEXP, SEXP timesSEXP, SEXP alternativesSEXP, SEXP startSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< List >::type schedule(scheduleSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type times(timesSEXP);
+    Rcpp::traits::input_parameter< IntegerVector >::type alternatives(alternativesSEXP);
+    Rcpp::traits::input_parameter< double >::type start(startSEXP);
+    rcpp_result_gen = Rcpp::wrap(CAB_cpp_run_schedule(schedule, times, alternatives, start));
+    return rcpp_result_gen;
+END_RCPP
+}
+// CAB_cpp_transitions_formal_event_record
+IntegerVector CAB_cpp_transitions_formal_event_record(DataFrame data, CharacterVector labels, CharacterVector break_events, int max_lag);
+RcppExport SEXP _CAB_CAB_cpp_transitions_formal_event_record(SEXP dataSEXP, SEXP labelsSEXP, SEXP break_eventsSEXP, SEXP max_lagSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< DataFrame >::type data(dataSEXP);
+    Rcpp::traits::input_parameter< CharacterVector >::type labels(labelsSEXP);
+    Rcpp::traits::input_parameter< CharacterVector >::type break_events(break_eventsSEXP);
+    Rcpp::traits::input_parameter< int >::type max_lag(max_lagSEXP);
+    rcpp_result_gen = Rcpp::wrap(CAB_cpp_transitions_formal_event_record(data, labels, break_events, max_lag));
+    return rcpp_result_gen;
+END_RCPP
+}
+// CAB_cpp_transitions_sessions
+List CAB_cpp_transitions_sessions(List sessions, CharacterVector labels, CharacterVector break_events, int max_lag);
+RcppExport SEXP _CAB_CAB_cpp_transitions_sessions(SEXP sessionsSEXP, SEXP labelsSEXP, SEXP break_eventsSEXP, SEXP max_lagSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< List >::type sessions(sessionsSEXP);
+    Rcpp::traits::input_parameter< CharacterVector >::type labels(labelsSEXP);
+    Rcpp::traits::input_parameter< CharacterVector >::type break_events(break_eventsSEXP);
+    Rcpp::traits::input_parameter< int >::type max_lag(max_lagSEXP);
+    rcpp_result_gen = Rcpp::wrap(CAB_cpp_transitions_sessions(sessions, labels, break_events, max_lag));
+    return rcpp_result_gen;
+END_RCPP
+}
+// CAB_cpp_windowed_rates_formal_event_record
+List CAB_cpp_windowed_rates_formal_event_record(DataFrame data, CharacterVector labels, double window, double step, double start, double end, double time_scale);
+RcppExport SEXP _CAB_CAB_cpp_windowed_rates_formal_event_record(SEXP dataSEXP, SEXP labelsSEXP, SEXP windowSEXP, SEXP stepSEXP, SEXP startSEXP, SEXP endSEXP, SEXP time_scaleSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< DataFrame >::type data(dataSEXP);
+    Rcpp::traits::input_parameter< CharacterVector >::type labels(labelsSEXP);
+    Rcpp::traits::input_parameter< double >::type window(windowSEXP);
+    Rcpp::traits::input_parameter< double >::type step(stepSEXP);
+    Rcpp::traits::input_parameter< double >::type start(startSEXP);
+    Rcpp::traits::input_parameter< double >::type end(endSEXP);
+    Rcpp::traits::input_parameter< double >::type time_scale(time_scaleSEXP);
+    rcpp_result_gen = Rcpp::wrap(CAB_cpp_windowed_rates_formal_event_record(data, labels, window, step, start, end, time_scale));
+    return rcpp_result_gen;
+END_RCPP
+}
+// CAB_cpp_windowed_rates_ragged_event_record
+List CAB_cpp_windowed_rates_ragged_event_record(List event_times, IntegerVector counts, double window, double step, double start, double end);
+RcppExport SEXP _CAB_CAB_cpp_windowed_rates_ragged_event_record(SEXP event_timesSEXP, SEXP countsSEXP, SEXP windowSEXP, SEXP stepSEXP, SEXP startSEXP, SEXP endSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< List >::type event_times(event_timesSEXP);
+    Rcpp::traits::input_parameter< IntegerVector >::type counts(countsSEXP);
+    Rcpp::traits::input_parameter< double >::type window(windowSEXP);
+    Rcpp::traits::input_parameter< double >::type step(stepSEXP);
+    Rcpp::traits::input_parameter< double >::type start(startSEXP);
+    Rcpp::traits::input_parameter< double >::type end(endSEXP);
+    rcpp_result_gen = Rcpp::wrap(CAB_cpp_windowed_rates_ragged_event_record(event_times, counts, window, step, start, end));
+    return rcpp_result_gen;
+END_RCPP
+}
+// CAB_cpp_windowed_rates_sessions
+List CAB_cpp_windowed_rates_sessions(List sessions, CharacterVector labels, double window, double step, NumericVector start, NumericVector end, double time_scale);
+RcppExport SEXP _CAB_CAB_cpp_windowed_rates_sessions(SEXP sessionsSEXP, SEXP labelsSEXP, SEXP windowSEXP, SEXP stepSEXP, SEXP startSEXP, SEXP endSEXP, SEXP time_scaleSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< List >::type sessions(sessionsSEXP);
+    Rcpp::traits::input_parameter< CharacterVector >::type labels(labelsSEXP);
+    Rcpp::traits::input_parameter< double >::type window(windowSEXP);
+    Rcpp::traits::input_parameter< double >::type step(stepSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type start(startSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type end(endSEXP);
+    Rcpp::traits::input_parameter< double >::type time_scale(time_scaleSEXP);
+    rcpp_result_gen = Rcpp::wrap(CAB_cpp_windowed_rates_sessions(sessions, labels, window, step, start, end, time_scale));
     return rcpp_result_gen;
 END_RCPP
 }
@@ -301,6 +653,110 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// CAB_cpp_EBD_batch
+List CAB_cpp_EBD_batch(List parameters, List schedule, IntegerMatrix phenotypes, double ticks, int max_reinforcers);
+RcppExport SEXP _CAB_CAB_cpp_EBD_batch(SEXP parametersSEXP, SEXP scheduleSEXP, SEXP phenotypesSEXP, SEXP ticksSEXP, SEXP max_reinforcersSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< List >::type parameters(parametersSEXP);
+    Rcpp::traits::input_parameter< List >::type schedule(scheduleSEXP);
+    Rcpp::traits::input_parameter< IntegerMatrix >::type phenotypes(phenotypesSEXP);
+    Rcpp::traits::input_parameter< double >::type ticks(ticksSEXP);
+    Rcpp::traits::input_parameter< int >::type max_reinforcers(max_reinforcersSEXP);
+    rcpp_result_gen = Rcpp::wrap(CAB_cpp_EBD_batch(parameters, schedule, phenotypes, ticks, max_reinforcers));
+    return rcpp_result_gen;
+END_RCPP
+}
+// CAB_cpp_EBD_session
+List CAB_cpp_EBD_session(List parameters, List components, List schedule, IntegerVector phenotypes, double ticks, int max_reinforcers, bool skip, SEXP state, bool reseed);
+RcppExport SEXP _CAB_CAB_cpp_EBD_session(SEXP parametersSEXP, SEXP componentsSEXP, SEXP scheduleSEXP, SEXP phenotypesSEXP, SEXP ticksSEXP, SEXP max_reinforcersSEXP, SEXP skipSEXP, SEXP stateSEXP, SEXP reseedSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< List >::type parameters(parametersSEXP);
+    Rcpp::traits::input_parameter< List >::type components(componentsSEXP);
+    Rcpp::traits::input_parameter< List >::type schedule(scheduleSEXP);
+    Rcpp::traits::input_parameter< IntegerVector >::type phenotypes(phenotypesSEXP);
+    Rcpp::traits::input_parameter< double >::type ticks(ticksSEXP);
+    Rcpp::traits::input_parameter< int >::type max_reinforcers(max_reinforcersSEXP);
+    Rcpp::traits::input_parameter< bool >::type skip(skipSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type state(stateSEXP);
+    Rcpp::traits::input_parameter< bool >::type reseed(reseedSEXP);
+    rcpp_result_gen = Rcpp::wrap(CAB_cpp_EBD_session(parameters, components, schedule, phenotypes, ticks, max_reinforcers, skip, state, reseed));
+    return rcpp_result_gen;
+END_RCPP
+}
+// CAB_cpp_EBD_state_info
+List CAB_cpp_EBD_state_info(RawVector state);
+RcppExport SEXP _CAB_CAB_cpp_EBD_state_info(SEXP stateSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< RawVector >::type state(stateSEXP);
+    rcpp_result_gen = Rcpp::wrap(CAB_cpp_EBD_state_info(state));
+    return rcpp_result_gen;
+END_RCPP
+}
+// CAB_cpp_EBD_fitness_weights
+List CAB_cpp_EBD_fitness_weights(IntegerVector phenotypes, int target, int max_phenotype, int distance, int weight, double parameter);
+RcppExport SEXP _CAB_CAB_cpp_EBD_fitness_weights(SEXP phenotypesSEXP, SEXP targetSEXP, SEXP max_phenotypeSEXP, SEXP distanceSEXP, SEXP weightSEXP, SEXP parameterSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< IntegerVector >::type phenotypes(phenotypesSEXP);
+    Rcpp::traits::input_parameter< int >::type target(targetSEXP);
+    Rcpp::traits::input_parameter< int >::type max_phenotype(max_phenotypeSEXP);
+    Rcpp::traits::input_parameter< int >::type distance(distanceSEXP);
+    Rcpp::traits::input_parameter< int >::type weight(weightSEXP);
+    Rcpp::traits::input_parameter< double >::type parameter(parameterSEXP);
+    rcpp_result_gen = Rcpp::wrap(CAB_cpp_EBD_fitness_weights(phenotypes, target, max_phenotype, distance, weight, parameter));
+    return rcpp_result_gen;
+END_RCPP
+}
+// CAB_cpp_EBD_weight_table
+NumericVector CAB_cpp_EBD_weight_table(int max_phenotype, int distance, int weight, double parameter);
+RcppExport SEXP _CAB_CAB_cpp_EBD_weight_table(SEXP max_phenotypeSEXP, SEXP distanceSEXP, SEXP weightSEXP, SEXP parameterSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< int >::type max_phenotype(max_phenotypeSEXP);
+    Rcpp::traits::input_parameter< int >::type distance(distanceSEXP);
+    Rcpp::traits::input_parameter< int >::type weight(weightSEXP);
+    Rcpp::traits::input_parameter< double >::type parameter(parameterSEXP);
+    rcpp_result_gen = Rcpp::wrap(CAB_cpp_EBD_weight_table(max_phenotype, distance, weight, parameter));
+    return rcpp_result_gen;
+END_RCPP
+}
+// CAB_cpp_EBD_table_fitness_weights
+List CAB_cpp_EBD_table_fitness_weights(IntegerVector phenotypes, int target, int max_phenotype, int distance, NumericVector table);
+RcppExport SEXP _CAB_CAB_cpp_EBD_table_fitness_weights(SEXP phenotypesSEXP, SEXP targetSEXP, SEXP max_phenotypeSEXP, SEXP distanceSEXP, SEXP tableSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< IntegerVector >::type phenotypes(phenotypesSEXP);
+    Rcpp::traits::input_parameter< int >::type target(targetSEXP);
+    Rcpp::traits::input_parameter< int >::type max_phenotype(max_phenotypeSEXP);
+    Rcpp::traits::input_parameter< int >::type distance(distanceSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type table(tableSEXP);
+    rcpp_result_gen = Rcpp::wrap(CAB_cpp_EBD_table_fitness_weights(phenotypes, target, max_phenotype, distance, table));
+    return rcpp_result_gen;
+END_RCPP
+}
+// CAB_cpp_EBD_histogram_selection
+IntegerMatrix CAB_cpp_EBD_histogram_selection(IntegerVector fitness, NumericVector table, int n_pairs, bool by_organism);
+RcppExport SEXP _CAB_CAB_cpp_EBD_histogram_selection(SEXP fitnessSEXP, SEXP tableSEXP, SEXP n_pairsSEXP, SEXP by_organismSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< IntegerVector >::type fitness(fitnessSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type table(tableSEXP);
+    Rcpp::traits::input_parameter< int >::type n_pairs(n_pairsSEXP);
+    Rcpp::traits::input_parameter< bool >::type by_organism(by_organismSEXP);
+    rcpp_result_gen = Rcpp::wrap(CAB_cpp_EBD_histogram_selection(fitness, table, n_pairs, by_organism));
+    return rcpp_result_gen;
+END_RCPP
+}
 // EBD_prp_race
 List EBD_prp_race(arma::uvec phenotypes, arma::uvec oc_lower, int prp_size);
 RcppExport SEXP _CAB_EBD_prp_race(SEXP phenotypesSEXP, SEXP oc_lowerSEXP, SEXP prp_sizeSEXP) {
@@ -314,14 +770,89 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// CAB_cpp_EBD_race
+List CAB_cpp_EBD_race(List points, List components, List schedule, int pop_size, double ticks, int loss, NumericVector observed, double target_rate, int min_replicates, int max_replicates, int batch, double z, double threshold, bool skip);
+RcppExport SEXP _CAB_CAB_cpp_EBD_race(SEXP pointsSEXP, SEXP componentsSEXP, SEXP scheduleSEXP, SEXP pop_sizeSEXP, SEXP ticksSEXP, SEXP lossSEXP, SEXP observedSEXP, SEXP target_rateSEXP, SEXP min_replicatesSEXP, SEXP max_replicatesSEXP, SEXP batchSEXP, SEXP zSEXP, SEXP thresholdSEXP, SEXP skipSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< List >::type points(pointsSEXP);
+    Rcpp::traits::input_parameter< List >::type components(componentsSEXP);
+    Rcpp::traits::input_parameter< List >::type schedule(scheduleSEXP);
+    Rcpp::traits::input_parameter< int >::type pop_size(pop_sizeSEXP);
+    Rcpp::traits::input_parameter< double >::type ticks(ticksSEXP);
+    Rcpp::traits::input_parameter< int >::type loss(lossSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type observed(observedSEXP);
+    Rcpp::traits::input_parameter< double >::type target_rate(target_rateSEXP);
+    Rcpp::traits::input_parameter< int >::type min_replicates(min_replicatesSEXP);
+    Rcpp::traits::input_parameter< int >::type max_replicates(max_replicatesSEXP);
+    Rcpp::traits::input_parameter< int >::type batch(batchSEXP);
+    Rcpp::traits::input_parameter< double >::type z(zSEXP);
+    Rcpp::traits::input_parameter< double >::type threshold(thresholdSEXP);
+    Rcpp::traits::input_parameter< bool >::type skip(skipSEXP);
+    rcpp_result_gen = Rcpp::wrap(CAB_cpp_EBD_race(points, components, schedule, pop_size, ticks, loss, observed, target_rate, min_replicates, max_replicates, batch, z, threshold, skip));
+    return rcpp_result_gen;
+END_RCPP
+}
+// CAB_cpp_emission_stream
+SEXP CAB_cpp_emission_stream(int pop_size, int block_size);
+RcppExport SEXP _CAB_CAB_cpp_emission_stream(SEXP pop_sizeSEXP, SEXP block_sizeSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< int >::type pop_size(pop_sizeSEXP);
+    Rcpp::traits::input_parameter< int >::type block_size(block_sizeSEXP);
+    rcpp_result_gen = Rcpp::wrap(CAB_cpp_emission_stream(pop_size, block_size));
+    return rcpp_result_gen;
+END_RCPP
+}
+// CAB_cpp_stream_emission
+SEXP CAB_cpp_stream_emission(SEXP stream, SEXP phenotypes);
+RcppExport SEXP _CAB_CAB_cpp_stream_emission(SEXP streamSEXP, SEXP phenotypesSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type stream(streamSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type phenotypes(phenotypesSEXP);
+    rcpp_result_gen = Rcpp::wrap(CAB_cpp_stream_emission(stream, phenotypes));
+    return rcpp_result_gen;
+END_RCPP
+}
+// CAB_cpp_gaussian_mutation_stream
+SEXP CAB_cpp_gaussian_mutation_stream(int pop_size, int n_mutants, double sd, int block_size);
+RcppExport SEXP _CAB_CAB_cpp_gaussian_mutation_stream(SEXP pop_sizeSEXP, SEXP n_mutantsSEXP, SEXP sdSEXP, SEXP block_sizeSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< int >::type pop_size(pop_sizeSEXP);
+    Rcpp::traits::input_parameter< int >::type n_mutants(n_mutantsSEXP);
+    Rcpp::traits::input_parameter< double >::type sd(sdSEXP);
+    Rcpp::traits::input_parameter< int >::type block_size(block_sizeSEXP);
+    rcpp_result_gen = Rcpp::wrap(CAB_cpp_gaussian_mutation_stream(pop_size, n_mutants, sd, block_size));
+    return rcpp_result_gen;
+END_RCPP
+}
+// CAB_cpp_stream_gaussian_mutation
+List CAB_cpp_stream_gaussian_mutation(SEXP stream, int max_phenotype, SEXP phenotypes);
+RcppExport SEXP _CAB_CAB_cpp_stream_gaussian_mutation(SEXP streamSEXP, SEXP max_phenotypeSEXP, SEXP phenotypesSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type stream(streamSEXP);
+    Rcpp::traits::input_parameter< int >::type max_phenotype(max_phenotypeSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type phenotypes(phenotypesSEXP);
+    rcpp_result_gen = Rcpp::wrap(CAB_cpp_stream_gaussian_mutation(stream, max_phenotype, phenotypes));
+    return rcpp_result_gen;
+END_RCPP
+}
 // preference_pulse_2A
-List preference_pulse_2A(CharacterVector event, NumericVector time, CharacterVector rft_labels, CharacterVector component_label, CharacterVector response_labels, double max_iri, double bin_resolution, double offset);
+List preference_pulse_2A(CharacterVector event, SEXP time, CharacterVector rft_labels, CharacterVector component_label, CharacterVector response_labels, double max_iri, double bin_resolution, double offset);
 RcppExport SEXP _CAB_preference_pulse_2A(SEXP eventSEXP, SEXP timeSEXP, SEXP rft_labelsSEXP, SEXP component_labelSEXP, SEXP response_labelsSEXP, SEXP max_iriSEXP, SEXP bin_resolutionSEXP, SEXP offsetSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
     Rcpp::traits::input_parameter< CharacterVector >::type event(eventSEXP);
-    Rcpp::traits::input_parameter< NumericVector >::type time(timeSEXP);
+    Rcpp::traits::input_parameter< SEXP >::type time(timeSEXP);
     Rcpp::traits::input_parameter< CharacterVector >::type rft_labels(rft_labelsSEXP);
     Rcpp::traits::input_parameter< CharacterVector >::type component_label(component_labelSEXP);
     Rcpp::traits::input_parameter< CharacterVector >::type response_labels(response_labelsSEXP);
@@ -378,28 +909,66 @@ END_RCPP
 static const R_CallMethodDef CallEntries[] = {
     {"_CAB_EBD_BR", (DL_FUNC) &_CAB_EBD_BR, 2},
     {"_CAB_EBD_RS_BR", (DL_FUNC) &_CAB_EBD_RS_BR, 1},
+    {"_CAB_CAB_cpp_bouts", (DL_FUNC) &_CAB_CAB_cpp_bouts, 6},
     {"_CAB_CAB_cpp_clean_short_ixyi", (DL_FUNC) &_CAB_CAB_cpp_clean_short_ixyi, 4},
     {"_CAB_CAB_cpp_clean_short_ixxi", (DL_FUNC) &_CAB_CAB_cpp_clean_short_ixxi, 3},
     {"_CAB_CAB_cpp_compute__I_xy_I__formal_event_record", (DL_FUNC) &_CAB_CAB_cpp_compute__I_xy_I__formal_event_record, 4},
+    {"_CAB_CAB_cpp_formal_to_ragged", (DL_FUNC) &_CAB_CAB_cpp_formal_to_ragged, 2},
+    {"_CAB_CAB_cpp_ragged_to_formal", (DL_FUNC) &_CAB_CAB_cpp_ragged_to_formal, 3},
     {"_CAB_CAB_cpp_diff", (DL_FUNC) &_CAB_CAB_cpp_diff, 1},
+    {"_CAB_CAB_cpp_event_label_index", (DL_FUNC) &_CAB_CAB_cpp_event_label_index, 2},
     {"_CAB_CAB_cpp_geometric_fitness_selection", (DL_FUNC) &_CAB_CAB_cpp_geometric_fitness_selection, 3},
+    {"_CAB_CAB_cpp_hash", (DL_FUNC) &_CAB_CAB_cpp_hash, 1},
     {"_CAB_CAB_cpp_indicator_matrix", (DL_FUNC) &_CAB_CAB_cpp_indicator_matrix, 1},
-    {"_CAB_CAB_cpp_int2bin", (DL_FUNC) &_CAB_CAB_cpp_int2bin, 2},
+    {"_CAB_CAB_cpp_int2bin", (DL_FUNC) &_CAB_CAB_cpp_int2bin, 3},
+    {"_CAB_CAB_cpp_bin2int", (DL_FUNC) &_CAB_CAB_cpp_bin2int, 2},
+    {"_CAB_CAB_cpp_unpack_bit_planes", (DL_FUNC) &_CAB_CAB_cpp_unpack_bit_planes, 2},
+    {"_CAB_CAB_cpp_irt_histograms", (DL_FUNC) &_CAB_CAB_cpp_irt_histograms, 9},
     {"_CAB_compute_ixyi_FER", (DL_FUNC) &_CAB_compute_ixyi_FER, 4},
     {"_CAB_compute_ixyi_FER_breaks", (DL_FUNC) &_CAB_compute_ixyi_FER_breaks, 5},
     {"_CAB_compute_ixxi_FER", (DL_FUNC) &_CAB_compute_ixxi_FER, 3},
     {"_CAB_compute_ixxi_FER_breaks", (DL_FUNC) &_CAB_compute_ixxi_FER_breaks, 4},
+    {"_CAB_compute_ixyi_indexed", (DL_FUNC) &_CAB_compute_ixyi_indexed, 8},
+    {"_CAB_compute_ixxi_indexed", (DL_FUNC) &_CAB_compute_ixxi_indexed, 7},
     {"_CAB_ks", (DL_FUNC) &_CAB_ks, 2},
     {"_CAB_CAB_cpp_local_times_formal_event_record", (DL_FUNC) &_CAB_CAB_cpp_local_times_formal_event_record, 5},
     {"_CAB_CAB_cpp_local_binning", (DL_FUNC) &_CAB_CAB_cpp_local_binning, 4},
     {"_CAB_CAB_cpp_local_times_ragged_event_record", (DL_FUNC) &_CAB_CAB_cpp_local_times_ragged_event_record, 3},
+    {"_CAB_CAB_cpp_profile_table", (DL_FUNC) &_CAB_CAB_cpp_profile_table, 0},
+    {"_CAB_CAB_cpp_profile_reset", (DL_FUNC) &_CAB_CAB_cpp_profile_reset, 0},
+    {"_CAB_CAB_cpp_profile_enabled", (DL_FUNC) &_CAB_CAB_cpp_profile_enabled, 0},
+    {"_CAB_CAB_cpp_profile_add", (DL_FUNC) &_CAB_CAB_cpp_profile_add, 2},
+    {"_CAB_CAB_cpp_radix_sort", (DL_FUNC) &_CAB_CAB_cpp_radix_sort, 1},
+    {"_CAB_CAB_cpp_radix_order", (DL_FUNC) &_CAB_CAB_cpp_radix_order, 1},
+    {"_CAB_CAB_cpp_unique", (DL_FUNC) &_CAB_CAB_cpp_unique, 1},
     {"_CAB_CAB_cpp_not_duplicated", (DL_FUNC) &_CAB_CAB_cpp_not_duplicated, 1},
+    {"_CAB_CAB_cpp_radix_rle", (DL_FUNC) &_CAB_CAB_cpp_radix_rle, 1},
+    {"_CAB_resample_indices", (DL_FUNC) &_CAB_resample_indices, 4},
+    {"_CAB_CAB_cpp_resample_statistic", (DL_FUNC) &_CAB_CAB_cpp_resample_statistic, 7},
     {"_CAB_mcdowell_sampling", (DL_FUNC) &_CAB_mcdowell_sampling, 2},
     {"_CAB_srswo", (DL_FUNC) &_CAB_srswo, 3},
     {"_CAB_srs", (DL_FUNC) &_CAB_srs, 3},
-    {"_CAB_CAB_cpp_unique", (DL_FUNC) &_CAB_CAB_cpp_unique, 1},
+    {"_CAB_CAB_cpp_schedule_batch", (DL_FUNC) &_CAB_CAB_cpp_schedule_batch, 2},
+    {"_CAB_CAB_cpp_run_schedule", (DL_FUNC) &_CAB_CAB_cpp_run_schedule, 4},
+    {"_CAB_CAB_cpp_transitions_formal_event_record", (DL_FUNC) &_CAB_CAB_cpp_transitions_formal_event_record, 4},
+    {"_CAB_CAB_cpp_transitions_sessions", (DL_FUNC) &_CAB_CAB_cpp_transitions_sessions, 4},
+    {"_CAB_CAB_cpp_windowed_rates_formal_event_record", (DL_FUNC) &_CAB_CAB_cpp_windowed_rates_formal_event_record, 7},
+    {"_CAB_CAB_cpp_windowed_rates_ragged_event_record", (DL_FUNC) &_CAB_CAB_cpp_windowed_rates_ragged_event_record, 6},
+    {"_CAB_CAB_cpp_windowed_rates_sessions", (DL_FUNC) &_CAB_CAB_cpp_windowed_rates_sessions, 7},
     {"_CAB_EBD_B_premutate", (DL_FUNC) &_CAB_EBD_B_premutate, 4},
+    {"_CAB_CAB_cpp_EBD_batch", (DL_FUNC) &_CAB_CAB_cpp_EBD_batch, 5},
+    {"_CAB_CAB_cpp_EBD_session", (DL_FUNC) &_CAB_CAB_cpp_EBD_session, 9},
+    {"_CAB_CAB_cpp_EBD_state_info", (DL_FUNC) &_CAB_CAB_cpp_EBD_state_info, 1},
+    {"_CAB_CAB_cpp_EBD_fitness_weights", (DL_FUNC) &_CAB_CAB_cpp_EBD_fitness_weights, 6},
+    {"_CAB_CAB_cpp_EBD_weight_table", (DL_FUNC) &_CAB_CAB_cpp_EBD_weight_table, 4},
+    {"_CAB_CAB_cpp_EBD_table_fitness_weights", (DL_FUNC) &_CAB_CAB_cpp_EBD_table_fitness_weights, 5},
+    {"_CAB_CAB_cpp_EBD_histogram_selection", (DL_FUNC) &_CAB_CAB_cpp_EBD_histogram_selection, 4},
     {"_CAB_EBD_prp_race", (DL_FUNC) &_CAB_EBD_prp_race, 3},
+    {"_CAB_CAB_cpp_EBD_race", (DL_FUNC) &_CAB_CAB_cpp_EBD_race, 14},
+    {"_CAB_CAB_cpp_emission_stream", (DL_FUNC) &_CAB_CAB_cpp_emission_stream, 2},
+    {"_CAB_CAB_cpp_stream_emission", (DL_FUNC) &_CAB_CAB_cpp_stream_emission, 2},
+    {"_CAB_CAB_cpp_gaussian_mutation_stream", (DL_FUNC) &_CAB_CAB_cpp_gaussian_mutation_stream, 4},
+    {"_CAB_CAB_cpp_stream_gaussian_mutation", (DL_FUNC) &_CAB_CAB_cpp_stream_gaussian_mutation, 3},
     {"_CAB_preference_pulse_2A", (DL_FUNC) &_CAB_preference_pulse_2A, 8},
     {"_CAB_simple_factorial_counts", (DL_FUNC) &_CAB_simple_factorial_counts, 6},
     {"_CAB_simple_ixyi", (DL_FUNC) &_CAB_simple_ixyi, 5},
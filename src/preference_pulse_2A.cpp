@@ -5,7 +5,7 @@ using namespace Rcpp ;
 
 //'@export preference_pulse_2A
 // [[Rcpp::export]]
-List preference_pulse_2A( CharacterVector event, NumericVector time, CharacterVector rft_labels, CharacterVector component_label, CharacterVector response_labels, double max_iri, double bin_resolution, double offset = 0){
+List preference_pulse_2A( CharacterVector event, SEXP time, CharacterVector rft_labels, CharacterVector component_label, CharacterVector response_labels, double max_iri, double bin_resolution, double offset = 0){
 
     IntegerVector rft_match = match( event, rft_labels );
     IntegerVector component_start_match = match( event, component_label );
@@ -13,7 +13,25 @@ List preference_pulse_2A( CharacterVector event, NumericVector time, CharacterVe
 
     int max_bin = ceil( max_iri );
     int n_bins = floor( max_bin / bin_resolution );
-    arma::uvec time_bins = as<arma::uvec>( wrap( floor( time / bin_resolution ) ) );
+
+    if ( Rf_length( time ) != event.length() ) stop( "'event' and 'time' must have the same length" );
+
+    // Integer ticks are binned with integer division when bin_resolution is a whole number of ticks
+    std::vector<int> time_bins( event.length() );
+    if ( TYPEOF( time ) == INTSXP && bin_resolution >= 1 && bin_resolution == floor( bin_resolution ) ){
+        IntegerVector ticks( time );
+        int width = bin_resolution;
+        for ( int i = 0; i < ticks.length(); i ++ ){
+            // Division truncates toward 0, so negative ticks are moved down a bin
+            time_bins[i] = ticks[i] / width - ( ticks[i] % width < 0 );
+        }
+    }
+    else{
+        NumericVector times( time );
+        for ( int i = 0; i < times.length(); i ++ ){
+            time_bins[i] = floor( times[i] / bin_resolution );
+        }
+    }
 
     int response_len = response_labels.length();
 
@@ -32,12 +50,12 @@ List preference_pulse_2A( CharacterVector event, NumericVector time, CharacterVe
         }
         if ( rft_match(i) != NA_INTEGER ){
             component_rft += 1;
-            rft_time = time_bins(i);
+            rft_time = time_bins[i];
             last_food_loc = rft_match(i);
         }
         if ( component_rft > 0 ){
             if ( resp_match(i) != NA_INTEGER ){
-                response_time = time_bins(i) - rft_time - offset;
+                response_time = time_bins[i] - rft_time - offset;
                 if ( response_time < n_bins ){
                     if ( last_food_loc == 1 ){
                         response_matrix1( response_time, resp_match(i) ) ++;
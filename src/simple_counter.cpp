@@ -1,5 +1,6 @@
 // [[Rcpp::depends(RcppArmadillo)]]
 #include "RcppArmadillo.h"
+#include "CAB_cpp_arena.h"
 using namespace Rcpp;
 
 //'@export simple_factorial_counts
@@ -78,9 +79,16 @@ List simple_ixyi(
     int ixyi_code = 0;
     bool got_x = false;
 
-    // Return objects
-    std::vector<double> ixyi_container(0);
-    std::vector<int> ixyi_indicator(0);
+    // Return objects. There is at most one IxyI for each y event.
+    scratch_scope scope;
+    int n_y = 0;
+    for ( int i = 0; i < i_max; i ++ ){
+        n_y += match_y(i) != NA_INTEGER;
+    }
+    scratch_vector<double> ixyi_container;
+    scratch_vector<int> ixyi_indicator;
+    ixyi_container.reserve( n_y );
+    ixyi_indicator.reserve( n_y );
     std::vector<int> ixyi_counter( n_x_types * y_events.length() );
 
     for ( int i = 0; i < i_max; i ++ ){
@@ -118,6 +126,9 @@ List simple_ixyi(
         }
     }
 
-    List return_list = List::create( Named("ixyi") = ixyi_container, Named("ixyi_type") = ixyi_indicator, Named("ixyi_counts") = ixyi_counter );
+    List return_list = List::create(
+        Named("ixyi") = NumericVector( ixyi_container.begin(), ixyi_container.end() ),
+        Named("ixyi_type") = IntegerVector( ixyi_indicator.begin(), ixyi_indicator.end() ),
+        Named("ixyi_counts") = ixyi_counter );
     return( return_list );
 }